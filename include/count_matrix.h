@@ -0,0 +1,110 @@
+#ifndef COUNT_MATRIX_H
+#define COUNT_MATRIX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One nonzero entry of a CountMatrix
+struct CountCell {
+    uint32_t col;
+    uint32_t count;
+};
+
+// Read-only view of one row of a CountMatrix
+class CellSpan {
+public:
+    CellSpan() = default;
+    CellSpan(const CountCell* first, const CountCell* last) : first_(first), last_(last) {}
+
+    const CountCell* begin() const { return first_; }
+    const CountCell* end() const { return last_; }
+    size_t size() const { return static_cast<size_t>(last_ - first_); }
+    bool empty() const { return first_ == last_; }
+    const CountCell& operator[](size_t i) const { return first_[i]; }
+
+private:
+    const CountCell* first_ = nullptr;
+    const CountCell* last_ = nullptr;
+};
+
+// Sparse matrix of counts between two dense index spaces (e.g. how many
+// routes each airline flies at each airport) in compressed-sparse-row
+// form. Only nonzero cells are stored, and each row is kept sorted by
+// count descending, so a "top N by count" report is a prefix of one row.
+//
+// Single route writes adjust cells in place: a changed cell moves past the
+// cells it now outranks, and a cell that appears or disappears shifts the
+// cells after it.
+class CountMatrix {
+public:
+    // Counts every column for rows 0..row_count-1: for_each_col(row, add)
+    // calls add(col) once per occurrence. col_order has one entry per
+    // column and breaks count ties, smallest first, so rows are
+    // deterministic.
+    template <typename ForEachCol>
+    void build(size_t row_count, const std::vector<uint32_t>& col_order, ForEachCol for_each_col) {
+        offsets_.assign(1, 0);
+        offsets_.reserve(row_count + 1);
+        cells_.clear();
+        col_order_ = col_order;
+        std::vector<uint32_t> counts(col_order.size(), 0);
+        std::vector<uint32_t> touched;
+        for (size_t r = 0; r < row_count; ++r) {
+            for_each_col(static_cast<uint32_t>(r), [&](uint32_t col) {
+                if (counts[col]++ == 0) {
+                    touched.push_back(col);
+                }
+            });
+            appendRow(counts, touched);
+        }
+    }
+
+    // Adds one occurrence of col to row r. order is col's tie-break, as in
+    // build()'s col_order; a row or column past the built ones grows the
+    // matrix.
+    void increment(uint32_t r, uint32_t col, uint32_t order);
+    // Removes one occurrence of col from row r; a cell reaching zero goes
+    void decrement(uint32_t r, uint32_t col);
+
+    size_t rowCount() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+    // Nonzero cells of row, highest count first
+    CellSpan row(uint32_t r) const {
+        if (r >= rowCount()) {
+            return CellSpan();
+        }
+        return CellSpan(cells_.data() + offsets_[r], cells_.data() + offsets_[r + 1]);
+    }
+
+    // The arrays themselves, for snapshots. assign() takes them back as
+    // they are, checking only what keeps reads in bounds: offsets run from
+    // 0 to cells.size() without decreasing and every cell's column has an
+    // entry in col_order, which has at most col_count. It returns false,
+    // leaving the matrix unchanged, when they do not.
+    const std::vector<uint32_t>& offsetArray() const { return offsets_; }
+    const std::vector<CountCell>& cellArray() const { return cells_; }
+    const std::vector<uint32_t>& colOrder() const { return col_order_; }
+    bool assign(std::vector<uint32_t> offsets, std::vector<CountCell> cells,
+                std::vector<uint32_t> col_order, size_t col_count);
+
+private:
+    bool before(const CountCell& a, const CountCell& b) const {
+        if (a.count != b.count) {
+            return a.count > b.count;
+        }
+        return col_order_[a.col] < col_order_[b.col];
+    }
+
+    // Emits the touched columns as one sorted row and zeroes their counts
+    void appendRow(std::vector<uint32_t>& counts, std::vector<uint32_t>& touched);
+    // Position of col's cell in row r, or the row's end
+    size_t find(uint32_t r, uint32_t col) const;
+
+    std::vector<uint32_t> offsets_;
+    std::vector<CountCell> cells_;
+    std::vector<uint32_t> col_order_;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef CSR_INDEX_H
+#define CSR_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Read-only view of a run of uint32 ids inside a CsrIndex
+class IdSpan {
+public:
+    IdSpan() = default;
+    IdSpan(const uint32_t* first, const uint32_t* last) : first_(first), last_(last) {}
+
+    const uint32_t* begin() const { return first_; }
+    const uint32_t* end() const { return last_; }
+    size_t size() const { return static_cast<size_t>(last_ - first_); }
+    bool empty() const { return first_ == last_; }
+    uint32_t operator[](size_t i) const { return first_[i]; }
+
+private:
+    const uint32_t* first_ = nullptr;
+    const uint32_t* last_ = nullptr;
+};
+
+// First position in [first, last) whose value is not less than value, for
+// ascending ids. Probes 1, 2, 4... places ahead before binary searching, so
+// the cost grows with the log of the distance moved: stepping a short
+// sorted list through a long one (an intersection) is
+// O(short * log(long / short)) rather than O(long).
+inline const uint32_t* gallopTo(const uint32_t* first, const uint32_t* last, uint32_t value) {
+    size_t step = 1;
+    const uint32_t* low = first;
+    while (static_cast<size_t>(last - low) > step && low[step] < value) {
+        low += step;
+        step *= 2;
+    }
+    const uint32_t* high = static_cast<size_t>(last - low) > step ? low + step + 1 : last;
+    return std::lower_bound(low, high, value);
+}
+
+// Route rows grouped by a dense key in compressed-sparse-row form: the rows
+// for key k are rows_[offsets_[k] .. offsets_[k + 1]), in ascending row
+// order. An optional neighbor column runs parallel to rows_, so adjacency
+// scans (e.g. the destinations out of one airport) read one contiguous
+// array without touching the route table. With neighbors, each key's run is
+// ordered by neighbor (then row) instead, so the routes to one neighbor are
+// a binary search away and two neighbor lists intersect by merging.
+//
+// Single route writes patch the index in place instead of rebuilding it:
+// each shifts the entries after the change and adjusts the offsets, one
+// linear pass with no sorting.
+class CsrIndex {
+public:
+    // Counting sort of row ids 0..keys.size()-1 by keys[row], which must be
+    // below key_count
+    void build(const std::vector<uint32_t>& keys, size_t key_count);
+    // The same with a neighbor column, one entry per row, which then
+    // orders rows within a key
+    void build(const std::vector<uint32_t>& keys, size_t key_count,
+               const std::vector<uint32_t>& neighbors);
+
+    // Adds row under key, in its place in the key's run. A key at or past
+    // keyCount() grows the index to cover it. neighbor is ignored by an
+    // index without a neighbor column.
+    void insert(uint32_t key, uint32_t row, uint32_t neighbor = 0);
+    // Removes row, filed under key with neighbor; other row ids are kept
+    void erase(uint32_t key, uint32_t row, uint32_t neighbor = 0);
+    // Removes the given rows (ascending) and renumbers the rest as
+    // RouteTable::eraseIf() does, each id moving down by the number of
+    // erased ids below it
+    void eraseRows(const std::vector<uint32_t>& erased);
+
+    size_t keyCount() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+    IdSpan rows(uint32_t key) const {
+        if (key >= keyCount()) {
+            return IdSpan();
+        }
+        return IdSpan(rows_.data() + offsets_[key], rows_.data() + offsets_[key + 1]);
+    }
+
+    // Neighbors of key, parallel to rows(key); empty when built without them
+    IdSpan neighbors(uint32_t key) const {
+        if (key >= keyCount() || !has_neighbors_) {
+            return IdSpan();
+        }
+        return IdSpan(neighbors_.data() + offsets_[key], neighbors_.data() + offsets_[key + 1]);
+    }
+
+    // The arrays themselves, for snapshots. assign() takes them back as
+    // they are, checking only what keeps reads in bounds: offsets run from
+    // 0 to rows.size() without decreasing, rows are below row_count, and
+    // neighbors, below neighbor_count, run parallel to rows (or are empty
+    // without a neighbor column). It returns false, leaving the index
+    // unchanged, when they do not.
+    const std::vector<uint32_t>& offsetArray() const { return offsets_; }
+    const std::vector<uint32_t>& rowArray() const { return rows_; }
+    const std::vector<uint32_t>& neighborArray() const { return neighbors_; }
+    bool hasNeighbors() const { return has_neighbors_; }
+    bool assign(std::vector<uint32_t> offsets, std::vector<uint32_t> rows,
+                std::vector<uint32_t> neighbors, bool has_neighbors, size_t row_count,
+                size_t neighbor_count);
+
+private:
+    void build(const std::vector<uint32_t>& keys, size_t key_count,
+               const std::vector<uint32_t>* neighbors);
+    // Where (neighbor, row) belongs in key's run
+    size_t position(uint32_t key, uint32_t row, uint32_t neighbor) const;
+
+    std::vector<uint32_t> offsets_;
+    std::vector<uint32_t> rows_;
+    std::vector<uint32_t> neighbors_;
+    bool has_neighbors_ = false;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef CSV_PARSER_H
+#define CSV_PARSER_H
+
+#include "models.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// OpenFlights .dat parsing: comma-separated, double-quoted fields with ""
+// as an escaped quote, and \N for NULL.
+class CSVParser {
+public:
+    // Reusable storage for the zero-copy parseLine(). Fields point into the
+    // line, or into scratch for fields that contained escaped quotes.
+    struct FieldBuffer {
+        std::vector<std::string_view> fields;
+        std::string scratch;
+        std::vector<uint64_t> masks;
+    };
+
+    static std::vector<std::string> parseLine(const std::string& line);
+    // Splits line into buffer.fields, which stay valid until the next call
+    // with the same buffer (and as long as line does)
+    static const std::vector<std::string_view>& parseLine(std::string_view line, FieldBuffer& buffer);
+
+    static bool isNull(std::string_view s);
+    static int parseInt(std::string_view s, int defaultVal = -1);
+    static double parseDouble(std::string_view s, double defaultVal = 0.0);
+    // The field with NULL markers mapped to ""
+    static std::string cleanString(std::string_view s);
+
+    static Airline parseAirline(const std::string& line);
+    static Airline parseAirline(const std::vector<std::string_view>& fields);
+    static Airport parseAirport(const std::string& line);
+    static Airport parseAirport(const std::vector<std::string_view>& fields);
+    static Route parseRoute(const std::string& line);
+    static Route parseRoute(const std::vector<std::string_view>& fields);
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef DATA_FILE_H
+#define DATA_FILE_H
+
+#include "mapped_file.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+class StreamDecoder;
+
+// Sequential reader for a .dat file that may be compressed. Plain files are
+// memory-mapped and returned as a single block. Files ending in .gz or .zst
+// are inflated on a producer thread into blocks of whole lines, so the
+// caller parses one block while the next is being decompressed.
+class DataFile {
+public:
+    DataFile() = default;
+    ~DataFile();
+
+    DataFile(const DataFile&) = delete;
+    DataFile& operator=(const DataFile&) = delete;
+
+    bool open(const std::string& filename);
+    void close();
+
+    // Next run of whole lines; false at the end of the input or after a
+    // decompression error. The view stays valid until the next call.
+    bool next(std::string_view& block);
+
+    // True when a compressed input was corrupt or truncated
+    bool failed() const;
+
+    bool compressed() const { return compressed_; }
+    size_t fileSize() const { return file_size_; } // Bytes on disk
+
+private:
+    void produce(std::unique_ptr<StreamDecoder> decoder);
+
+    MappedFile mapped_;
+    bool compressed_ = false;
+    bool mapped_pending_ = false;
+    size_t file_size_ = 0;
+
+    // Producer/consumer hand-off for compressed input
+    std::thread producer_;
+    mutable std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::condition_variable space_cv_;
+    std::deque<std::string> ready_;
+    std::string current_;
+    bool done_ = false;
+    bool error_ = false;
+    bool stop_ = false;
+};
+
+// Returns the first of filename, filename.zst and filename.gz that exists,
+// skipping formats this build cannot read; filename itself if none do
+std::string resolveDataFile(const std::string& filename);
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef DATA_RELOADER_H
+#define DATA_RELOADER_H
+
+#include "live_database.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Rebuilds the database from the data files on a background thread and
+// swaps it into a LiveDatabase. Requests keep being served from the old
+// instance until the new one is complete.
+//
+// Reloads are triggered with requestReload() (the admin endpoint) or by
+// watching the data directory with inotify. Requests that arrive while a
+// reload is running fold into one follow-up reload.
+class DataReloader {
+public:
+    // Builds a fresh Database, or returns nullptr when loading fails
+    using LoadFn = std::function<std::shared_ptr<Database>()>;
+
+    DataReloader(LiveDatabase& live, LoadFn load);
+    ~DataReloader();
+
+    DataReloader(const DataReloader&) = delete;
+    DataReloader& operator=(const DataReloader&) = delete;
+
+    void requestReload();
+    bool reloading() const { return reloading_.load(); }
+    uint64_t failures() const { return failures_.load(); }
+
+    // Reloads whenever one of files in directory is rewritten or replaced
+    bool watch(const std::string& directory, const std::vector<std::string>& files);
+
+private:
+    void workerLoop();
+    void watchLoop(int fd, std::vector<std::string> files);
+
+    LiveDatabase& live_;
+    LoadFn load_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    bool requested_ = false;
+    bool stopping_ = false;
+    std::atomic<bool> reloading_{false};
+    std::atomic<uint64_t> failures_{0};
+
+    std::thread worker_;
+    std::thread watcher_;
+    int inotify_fd_ = -1;
+};
+
+#endif
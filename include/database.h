@@ -0,0 +1,162 @@
+#ifndef DATABASE_H
+#define DATABASE_H
+
+#include "models.h"
+#include "iata_code.h"
+#include "route_table.h"
+#include "csr_index.h"
+#include "count_matrix.h"
+#include "traffic_ranking.h"
+#include "great_circle.h"
+#include "itinerary_search.h"
+#include "reachability_index.h"
+#include "trigram_index.h"
+#include "entity_table.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+struct LoadProgress;
+struct LoadReport;
+
+// The airline, airport and route tables with every index the endpoints
+// read. Loads run on one instance before it is published; afterwards it is
+// read concurrently and written only through a private copy (see
+// LiveDatabase).
+class Database {
+public:
+    Database();
+    // Copies every table and index; load hooks are not copied
+    Database(const Database& other);
+    ~Database();
+
+    // Loading, in this order: routes resolve their airlines and airports,
+    // and loadRoutes() builds the indexes
+    bool loadAirlines(const std::string& filename);
+    bool loadAirports(const std::string& filename);
+    bool loadRoutes(const std::string& filename);
+    // Optional observers for the next loads; may be null
+    void setLoadProgress(LoadProgress* progress);
+    void setLoadReport(LoadReport* report);
+
+    // Binary snapshot of the tables, valid while the source files keep the
+    // size and modification time they had when it was written
+    bool saveSnapshot(const std::string& path, const std::vector<std::string>& sources) const;
+    bool loadSnapshot(const std::string& path, const std::vector<std::string>& sources);
+
+    // Copying reads; an entity with id -1 means not found
+    Airline getAirlineByIATA(IataCode iata) const;
+    Airport getAirportByIATA(IataCode iata) const;
+    std::vector<AirportRouteCount> getAirportsByAirline(IataCode airline_iata) const;
+    std::vector<AirlineRouteCount> getAirlinesByAirport(IataCode airport_iata) const;
+    std::vector<Airline> getAllAirlinesSorted() const;
+    std::vector<Airport> getAllAirportsSorted() const;
+
+    // Non-copying reads. Views and ranges point into this Database and
+    // stay valid as long as it does; a view with id -1 means not found.
+    AirlineView findAirline(IataCode iata) const;
+    std::vector<AirportCountView> airportsServedBy(IataCode airline_iata) const;
+    std::vector<AirlineCountView> airlinesServing(IataCode airport_iata) const;
+    std::vector<AirportTrafficView> topAirports(size_t limit) const;
+    AirportView findAirport(IataCode iata) const;
+    EntityRange<Airline> airlinesSorted() const;
+    EntityRange<Airport> airportsSorted() const;
+    std::string getStudentInfo() const;
+
+    // Route queries
+    struct AirlinePair {
+        std::string first_leg;
+        std::string second_leg;
+    };
+    struct OneHopRoute {
+        std::string intermediate;
+        // First leg of the first pair in airlines
+        std::string airline;
+        // Every (first leg, second leg) airline combination, in code order
+        std::vector<AirlinePair> airlines;
+        double distance;
+    };
+    struct DirectRoute {
+        std::string airline_iata;
+        std::string airline_name;
+        double distance;
+        int stops;
+    };
+    std::vector<OneHopRoute> getOneHopRoutes(IataCode source_iata, IataCode dest_iata) const;
+    std::vector<DirectRoute> getDirectRoutes(IataCode source_iata, IataCode dest_iata) const;
+    // Top itineraries of up to query.max_legs legs, best first
+    ItineraryResult findItineraries(IataCode source, IataCode dest, const ItineraryQuery& query) const;
+    // Fewest flights for each (source, dest) pair, up to ReachabilityIndex::kMaxHops;
+    // ReachabilityIndex::kUnreachable beyond that or for unknown airports
+    std::vector<uint32_t> hopCounts(const std::vector<std::pair<IataCode, IataCode>>& pairs) const;
+    // Best `limit` airports whose IATA code or name contains query, ignoring case
+    std::vector<AirportView> searchAirports(std::string_view query, size_t limit) const;
+
+    // Writes. Each keeps every index current before it returns.
+    struct UpdateResult {
+        bool success = false;
+        std::string message;
+    };
+    UpdateResult insertAirline(const Airline& airline);
+    UpdateResult updateAirline(const std::string& iata, const Airline& updates);
+    UpdateResult deleteAirline(const std::string& iata);
+    UpdateResult insertAirport(const Airport& airport);
+    UpdateResult updateAirport(const std::string& iata, const Airport& updates);
+    UpdateResult deleteAirport(const std::string& iata);
+    UpdateResult insertRoute(const Route& route);
+    UpdateResult updateRoute(int route_id, const Route& updates);
+    UpdateResult deleteRoute(int route_id);
+
+    double calculateDistance(const Airport& a1, const Airport& a2) const;
+
+private:
+    LoadProgress* progress_ = nullptr;
+    LoadReport* report_ = nullptr;
+
+    // Index maintenance
+    void buildIndexes();
+    void buildCountMatrices();
+    void buildRouteIndexes();
+    // Single route writes patch the route indexes and count matrices
+    void indexRoute(uint32_t r);
+    void unindexRoute(uint32_t r);
+    void countRoute(uint32_t r, bool add);
+    void eraseRoutes(std::vector<uint32_t> rows);
+    TrafficRanking::Entry airportTraffic(IataCode code) const;
+    void rankAirports();
+    void rankAirports(std::vector<IataCode> codes);
+    void rankAirport(IataCode code);
+    void locateAirports();
+    void growAirportGeo();
+    void locateAirport(IataCode code);
+    void measureRoute(size_t r);
+    bool routable(uint32_t airport) const;
+    void buildReachability();
+    void linkAirports(uint32_t source, uint32_t dest);
+    void unlinkAirports(uint32_t source, uint32_t dest);
+    void indexAirportNames();
+    int getNextAirlineId() const;
+    int getNextAirportId() const;
+    int getNextRouteId() const;
+
+    EntityTable<Airline> airlines;
+    EntityTable<Airport> airports;
+    RouteTable routes;
+    // Route rows by dense source / dest airport index (with the airport at
+    // the other end as neighbor) and by dense airline index
+    CsrIndex routes_by_source;
+    CsrIndex routes_by_dest;
+    CsrIndex routes_by_airline;
+    // Route counts per airline x airport, both ways round
+    CountMatrix airports_by_airline;
+    CountMatrix airlines_by_airport;
+    TrafficRanking airport_traffic;
+    // Position of each dense airport index
+    std::vector<GeoPoint> airport_geo;
+    ReachabilityIndex reachability;
+    TrigramIndex airport_search;
+};
+
+#endif
@@ -0,0 +1,354 @@
+#ifndef ENTITY_TABLE_H
+#define ENTITY_TABLE_H
+
+#include "flat_code_map.h"
+#include "iata_code.h"
+#include "models.h"
+#include "sorted_code_index.h"
+#include "string_arena.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Stored forms of Airline and Airport: numeric fields by value, text as
+// references into the owning table's StringArena
+struct AirlineRow {
+    int32_t id;
+    StrRef name, alias, iata, icao, callsign, country, active;
+};
+
+struct AirportRow {
+    double latitude;
+    double longitude;
+    double timezone;
+    int32_t id;
+    int32_t altitude;
+    StrRef name, city, country, iata, icao, dst, tz, type, source;
+};
+
+// Read-only views of stored rows: the Airline / Airport field names, with
+// text as string_views into the table's arena. Building one copies no
+// text; it stays valid until the table is next modified, which for a
+// published Database means for as long as the instance is held.
+struct AirlineView {
+    int id = -1;
+    std::string_view name, alias, iata, icao, callsign, country, active;
+};
+
+struct AirportView {
+    int id = -1;
+    std::string_view name, city, country, iata, icao;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    int altitude = 0;
+    double timezone = 0.0;
+    std::string_view dst, tz, type, source;
+};
+
+// Rows of the per-airline / per-airport route count reports
+struct AirportCountView {
+    AirportView airport;
+    int route_count;
+};
+
+struct AirlineCountView {
+    AirlineView airline;
+    int route_count;
+};
+
+// One row of the airport traffic ranking
+struct AirportTrafficView {
+    AirportView airport;
+    int route_count;
+    int airline_count;
+};
+
+// Row and view types of each entity and the conversions between them
+template <typename Entity>
+struct EntityRows;
+
+template <>
+struct EntityRows<Airline> {
+    using Row = AirlineRow;
+    using View = AirlineView;
+
+    // Fills row from airline; text already in row is kept when unchanged
+    static void store(const Airline& airline, Row& row, StringArena& arena);
+    static Airline load(const Row& row, const StringArena& arena);
+
+    static View view(const Row& row, const StringArena& arena) {
+        View v;
+        v.id = row.id;
+        v.name = arena.view(row.name);
+        v.alias = arena.view(row.alias);
+        v.iata = arena.view(row.iata);
+        v.icao = arena.view(row.icao);
+        v.callsign = arena.view(row.callsign);
+        v.country = arena.view(row.country);
+        v.active = arena.view(row.active);
+        return v;
+    }
+
+    template <typename Fn>
+    static void forEachText(Row& row, Fn fn) {
+        for (StrRef* ref : {&row.name, &row.alias, &row.iata, &row.icao, &row.callsign,
+                            &row.country, &row.active}) {
+            fn(*ref);
+        }
+    }
+};
+
+template <>
+struct EntityRows<Airport> {
+    using Row = AirportRow;
+    using View = AirportView;
+
+    static void store(const Airport& airport, Row& row, StringArena& arena);
+    static Airport load(const Row& row, const StringArena& arena);
+
+    static View view(const Row& row, const StringArena& arena) {
+        View v;
+        v.id = row.id;
+        v.name = arena.view(row.name);
+        v.city = arena.view(row.city);
+        v.country = arena.view(row.country);
+        v.iata = arena.view(row.iata);
+        v.icao = arena.view(row.icao);
+        v.latitude = row.latitude;
+        v.longitude = row.longitude;
+        v.altitude = row.altitude;
+        v.timezone = row.timezone;
+        v.dst = arena.view(row.dst);
+        v.tz = arena.view(row.tz);
+        v.type = arena.view(row.type);
+        v.source = arena.view(row.source);
+        return v;
+    }
+
+    template <typename Fn>
+    static void forEachText(Row& row, Fn fn) {
+        for (StrRef* ref : {&row.name, &row.city, &row.country, &row.iata, &row.icao,
+                            &row.dst, &row.tz, &row.type, &row.source}) {
+            fn(*ref);
+        }
+    }
+};
+
+template <typename Entity>
+class EntityRange;
+
+// Single owner of every Airline or Airport. Each entity is stored once, in
+// a contiguous row vector whose text fields point into one StringArena;
+// the IATA hash index (a FlatCodeMap), the id index and the IATA-sorted
+// order all hold 32-bit row ids into it, so an update edits one row and
+// nothing has to be copied back into the indexes. Entity structs are
+// materialized only at the API boundary (get()).
+//
+// Ids are unique per table. Codes need not be: the code index points at
+// the last row added for a code, and earlier rows with the same code stay
+// reachable by id only.
+template <typename Entity>
+class EntityTable {
+public:
+    using Rows = EntityRows<Entity>;
+    using Row = typename Rows::Row;
+    using View = typename Rows::View;
+
+    static const uint32_t kNone = UINT32_MAX;
+
+    size_t size() const { return rows_.size(); }
+    void reserve(size_t n) {
+        rows_.reserve(n);
+        by_id_.reserve(n);
+        by_code_.reserve(n);
+    }
+
+    Entity get(uint32_t row) const { return Rows::load(rows_[row], arena_); }
+    View view(uint32_t row) const { return Rows::view(rows_[row], arena_); }
+    const Row& row(uint32_t row) const { return rows_[row]; }
+    std::string_view text(StrRef ref) const { return arena_.view(ref); }
+    IataCode code(uint32_t row) const { return IataCode(text(rows_[row].iata)); }
+
+    // Replaces a row's fields; its id and iata must not change, as they
+    // are indexed
+    void set(uint32_t row, const Entity& entity) {
+        Rows::store(entity, rows_[row], arena_);
+        compactIfSparse();
+    }
+
+    // kNone when no row has the code / id
+    uint32_t find(IataCode code) const { return by_code_.find(code); }
+    uint32_t findId(int id) const {
+        auto it = by_id_.find(id);
+        return it == by_id_.end() ? kNone : it->second;
+    }
+
+    // Rows in code order, one per code
+    const SortedCodeIndex& sorted() const { return sorted_; }
+    EntityRange<Entity> sortedViews() const;
+
+    // Stores entity under its id, replacing the row that already has that
+    // id, and makes it the row for code
+    uint32_t insert(IataCode code, const Entity& entity) {
+        uint32_t row = append(entity);
+        setCode(code, row);
+        return row;
+    }
+
+    // Like insert() for bulk loads: the row is findable at once, but
+    // sorted() only includes it after commit(), which merges every staged
+    // row into the sorted order in one pass
+    uint32_t stage(IataCode code, const Entity& entity) {
+        uint32_t row = append(entity);
+        by_code_.set(code, row);
+        sorted_.stage(code, row);
+        return row;
+    }
+    void commit() { sorted_.merge(); }
+
+    // Stores entity under its id only; setCode() adds it to the code index
+    uint32_t append(const Entity& entity) {
+        uint32_t row = findId(entity.id);
+        if (row == kNone) {
+            Row stored = Row();
+            Rows::store(entity, stored, arena_);
+            return appendRow(stored);
+        }
+        unlinkCode(row);
+        set(row, entity);
+        return row;
+    }
+
+    // Like append(), for a row whose text already lives in arena(); the
+    // id must be new
+    uint32_t appendRow(const Row& stored) {
+        uint32_t row = static_cast<uint32_t>(rows_.size());
+        if (!by_id_.emplace(stored.id, row).second) {
+            return by_id_[stored.id];
+        }
+        rows_.push_back(stored);
+        return row;
+    }
+
+    void setCode(IataCode code, uint32_t row) {
+        by_code_.set(code, row);
+        sorted_.set(code, row);
+    }
+
+    // Removes a row. The last row moves into its slot and its index
+    // entries are repointed, so row ids past the erased one are not stable.
+    void erase(uint32_t row) {
+        unlinkCode(row);
+        by_id_.erase(rows_[row].id);
+        Rows::forEachText(rows_[row], [&](StrRef& ref) { arena_.release(ref); });
+        uint32_t last = static_cast<uint32_t>(rows_.size() - 1);
+        if (row != last) {
+            IataCode moved_code = code(last);
+            if (by_code_.find(moved_code) == last) {
+                by_code_.set(moved_code, row);
+                sorted_.set(moved_code, row);
+            }
+            by_id_[rows_[last].id] = row;
+            rows_[row] = rows_[last];
+        }
+        rows_.pop_back();
+        compactIfSparse();
+    }
+
+    StringArena& arena() { return arena_; }
+    const StringArena& arena() const { return arena_; }
+
+private:
+    // Drops the code index entry for row, if the code still points at it
+    void unlinkCode(uint32_t row) {
+        IataCode row_code = code(row);
+        if (by_code_.find(row_code) == row) {
+            by_code_.erase(row_code);
+            sorted_.erase(row_code);
+        }
+    }
+
+    // Copies the live text into a fresh arena once more than half of the
+    // current one is dead, so repeated updates cannot grow it unbounded
+    void compactIfSparse() {
+        if (arena_.dead() * 2 <= arena_.size()) {
+            return;
+        }
+        StringArena fresh;
+        fresh.reserve(arena_.size() - arena_.dead());
+        for (Row& stored : rows_) {
+            Rows::forEachText(stored, [&](StrRef& ref) { ref = fresh.add(arena_.view(ref)); });
+        }
+        arena_ = std::move(fresh);
+    }
+
+    std::vector<Row> rows_;
+    StringArena arena_;
+    std::unordered_map<int, uint32_t> by_id_;
+    FlatCodeMap by_code_;
+    SortedCodeIndex sorted_;
+};
+
+// A sequence of rows of one EntityTable, e.g. in code order, read as views.
+// Holds pointers into the table, so it is valid exactly as long as the
+// views it hands out.
+template <typename Entity>
+class EntityRange {
+public:
+    using View = typename EntityRows<Entity>::View;
+
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = View;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const View*;
+        using reference = View;
+
+        iterator(const EntityTable<Entity>* table, const uint32_t* row) : table_(table), row_(row) {}
+        View operator*() const { return table_->view(*row_); }
+        iterator& operator++() {
+            ++row_;
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return row_ == other.row_; }
+        bool operator!=(const iterator& other) const { return row_ != other.row_; }
+
+    private:
+        const EntityTable<Entity>* table_;
+        const uint32_t* row_;
+    };
+
+    EntityRange(const EntityTable<Entity>* table, const uint32_t* first, const uint32_t* last)
+        : table_(table), first_(first), last_(last) {}
+
+    size_t size() const { return static_cast<size_t>(last_ - first_); }
+    bool empty() const { return first_ == last_; }
+    View operator[](size_t i) const { return table_->view(first_[i]); }
+    iterator begin() const { return iterator(table_, first_); }
+    iterator end() const { return iterator(table_, last_); }
+
+    // Up to count rows starting at offset, e.g. one page of a listing
+    EntityRange slice(size_t offset, size_t count) const {
+        const uint32_t* first = first_ + std::min(offset, size());
+        const uint32_t* last = first + std::min(count, static_cast<size_t>(last_ - first));
+        return EntityRange(table_, first, last);
+    }
+
+private:
+    const EntityTable<Entity>* table_;
+    const uint32_t* first_;
+    const uint32_t* last_;
+};
+
+template <typename Entity>
+EntityRange<Entity> EntityTable<Entity>::sortedViews() const {
+    const std::vector<uint32_t>& rows = sorted_.rows();
+    return EntityRange<Entity>(this, rows.data(), rows.data() + rows.size());
+}
+
+#endif
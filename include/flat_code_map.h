@@ -0,0 +1,109 @@
+#ifndef FLAT_CODE_MAP_H
+#define FLAT_CODE_MAP_H
+
+#include "iata_code.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define FLAT_CODE_MAP_SSE2 1
+#endif
+
+// Open-addressing hash map from IataCode to a uint32 (e.g. a row id),
+// laid out like a Swiss table. Slots come in groups of 16 with one control
+// byte each: the top 7 bits of the slot's hash, or kEmpty / kDeleted. A
+// lookup hashes once, then compares the whole group's control bytes with
+// one SSE2 instruction and only touches slots whose 7-bit tag matches, so
+// a hit usually costs one control-byte load and one key compare, and keys
+// and values sit inline in one flat array instead of one heap node each.
+class FlatCodeMap {
+public:
+    static const uint32_t kNone = UINT32_MAX;
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    void clear();
+    void reserve(size_t n);
+
+    // kNone when code is absent
+    uint32_t find(IataCode code) const {
+        size_t slot = locate(code, hash(code));
+        return slot == SIZE_MAX ? kNone : slots_[slot].value;
+    }
+
+    // Inserts or overwrites
+    void set(IataCode code, uint32_t value);
+    // False when code was absent
+    bool erase(IataCode code);
+
+private:
+    static constexpr size_t kGroupSize = 16;
+    static constexpr uint8_t kEmpty = 0x80;
+    static constexpr uint8_t kDeleted = 0xFE;
+
+    struct Slot {
+        uint32_t key;
+        uint32_t value;
+    };
+
+    // Groups are picked by the low bits and tags by the top 7 bits of the
+    // same hash the node-based IataMap uses
+    static uint64_t hash(IataCode code) { return IataCodeHash()(code); }
+    // Full slots hold 0..127, so tags never collide with kEmpty / kDeleted
+    static uint8_t tagOf(uint64_t h) { return static_cast<uint8_t>(h >> 57); }
+    size_t groupOf(uint64_t h) const { return static_cast<size_t>(h) & group_mask_; }
+
+    // Bit i set when ctrl[i] == tag
+    static uint32_t matchTag(const uint8_t* ctrl, uint8_t tag) {
+#ifdef FLAT_CODE_MAP_SSE2
+        __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        __m128i hits = _mm_cmpeq_epi8(group, _mm_set1_epi8(static_cast<char>(tag)));
+        return static_cast<uint32_t>(_mm_movemask_epi8(hits));
+#else
+        uint32_t hits = 0;
+        for (size_t i = 0; i < kGroupSize; ++i) {
+            hits |= static_cast<uint32_t>(ctrl[i] == tag) << i;
+        }
+        return hits;
+#endif
+    }
+
+    // Slot index where code is stored, or SIZE_MAX. Groups are probed
+    // quadratically (1, 2, 3... groups apart), which visits every group of
+    // a power-of-two table; a group with an empty slot ends the search.
+    size_t locate(IataCode code, uint64_t h) const {
+        if (size_ == 0) {
+            return SIZE_MAX;
+        }
+        uint8_t tag = tagOf(h);
+        size_t group = groupOf(h);
+        for (size_t step = 1;; ++step) {
+            const uint8_t* ctrl = ctrl_.data() + group * kGroupSize;
+            for (uint32_t hits = matchTag(ctrl, tag); hits != 0; hits &= hits - 1) {
+                size_t slot = group * kGroupSize + __builtin_ctz(hits);
+                if (slots_[slot].key == code.raw()) {
+                    return slot;
+                }
+            }
+            if (matchTag(ctrl, kEmpty) != 0) {
+                return SIZE_MAX;
+            }
+            group = (group + step) & group_mask_;
+        }
+    }
+
+    // Adds a code known to be absent; the table must have growth left
+    void insertNew(uint64_t h, uint32_t key, uint32_t value);
+    void rehash(size_t groups);
+
+    std::vector<uint8_t> ctrl_;
+    std::vector<Slot> slots_;
+    size_t group_mask_ = 0;
+    size_t size_ = 0;
+    // Empty slots that may still be filled before the table must grow
+    size_t growth_left_ = 0;
+};
+
+#endif
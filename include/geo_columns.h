@@ -0,0 +1,44 @@
+#ifndef GEO_COLUMNS_H
+#define GEO_COLUMNS_H
+
+#include <cstddef>
+#include <vector>
+
+// Many positions in structure-of-arrays form, for distances in bulk (radius
+// searches, histograms, all-pairs sweeps). Each position is stored as its
+// unit vector, so a distance is a chord length and one arcsine: the kernel
+// needs no sin/cos per pair, and both its sqrt and its polynomial arcsine
+// run several pairs per SIMD instruction. Positions are converted with
+// polynomial sin/cos, also vectorized.
+//
+// The vector width is fixed at compile time, not picked per CPU as the CSV
+// kernels are: AVX (4 pairs) only when the compiler targets it (__AVX__,
+// e.g. -mavx or -march=native), so the default x86-64 build runs SSE2
+// (2 pairs).
+//
+// Results agree with haversineMiles() (great_circle.h) to about 1e-8
+// miles, and to about 8e-6 for nearly antipodal pairs, where both formulas
+// lose precision to the same degree; geo_columns_bench measures the bound
+// and tests/geo_columns_test checks every pair of bundled airports.
+class GeoColumns {
+public:
+    size_t size() const { return x_.size(); }
+
+    // Replaces the positions. Latitudes must lie in [-90, 90] and
+    // longitudes in [-180, 180] degrees.
+    void assign(const double* latitude_deg, const double* longitude_deg, size_t n);
+
+    // out[i] = miles from the given position / from position `from` to
+    // position i, for every i < size()
+    void milesFrom(double latitude_deg, double longitude_deg, double* out) const;
+    void milesFrom(size_t from, double* out) const;
+
+private:
+    void milesFromUnit(double x, double y, double z, double* out) const;
+
+    std::vector<double> x_;
+    std::vector<double> y_;
+    std::vector<double> z_;
+};
+
+#endif
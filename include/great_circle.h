@@ -0,0 +1,34 @@
+#ifndef GREAT_CIRCLE_H
+#define GREAT_CIRCLE_H
+
+#include <cmath>
+
+// Mean Earth radius used for every distance the API reports
+const double kEarthRadiusMiles = 3959.0;
+
+// A position prepared for haversine: both angles in radians and the cosine
+// of the latitude, so a distance between two prepared points needs no
+// degree conversion and one cosine fewer per endpoint
+struct GeoPoint {
+    double lat_rad = 0.0;
+    double lon_rad = 0.0;
+    double cos_lat = 1.0;
+};
+
+inline GeoPoint geoPoint(double latitude_deg, double longitude_deg) {
+    GeoPoint p;
+    p.lat_rad = latitude_deg * M_PI / 180.0;
+    p.lon_rad = longitude_deg * M_PI / 180.0;
+    p.cos_lat = std::cos(p.lat_rad);
+    return p;
+}
+
+// Great-circle distance by the haversine formula
+inline double haversineMiles(const GeoPoint& a, const GeoPoint& b) {
+    double sin_dlat = std::sin((b.lat_rad - a.lat_rad) / 2);
+    double sin_dlon = std::sin((b.lon_rad - a.lon_rad) / 2);
+    double h = sin_dlat * sin_dlat + a.cos_lat * b.cos_lat * sin_dlon * sin_dlon;
+    return kEarthRadiusMiles * 2 * std::atan2(std::sqrt(h), std::sqrt(1 - h));
+}
+
+#endif
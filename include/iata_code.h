@@ -0,0 +1,77 @@
+#ifndef IATA_CODE_H
+#define IATA_CODE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// An airline or airport code (IATA codes are 2-3 characters; up to 4 are
+// accepted) packed into one integer. The first character sits in the top
+// byte and short codes are zero-padded, so comparing the integers orders
+// codes exactly like comparing the strings. The empty code packs to 0.
+class IataCode {
+public:
+    static const size_t kMaxLength = 4;
+
+    constexpr IataCode() = default;
+
+    // Packs text known to fit, e.g. the code of a record already stored in
+    // the Database; characters past kMaxLength are ignored
+    explicit IataCode(std::string_view text) {
+        size_t n = text.size() < kMaxLength ? text.size() : kMaxLength;
+        for (size_t i = 0; i < n; ++i) {
+            value_ |= static_cast<uint32_t>(static_cast<unsigned char>(text[i])) << (24 - 8 * i);
+        }
+    }
+
+    // Packs untrusted text such as a request path; false when it is too
+    // long to be a code
+    static bool parse(std::string_view text, IataCode& code) {
+        if (text.size() > kMaxLength) {
+            return false;
+        }
+        code = IataCode(text);
+        return true;
+    }
+
+    bool empty() const { return value_ == 0; }
+    uint32_t raw() const { return value_; }
+
+    static IataCode fromRaw(uint32_t value) {
+        IataCode code;
+        code.value_ = value;
+        return code;
+    }
+
+    std::string str() const {
+        std::string text;
+        for (int shift = 24; shift >= 0 && ((value_ >> shift) & 0xFF) != 0; shift -= 8) {
+            text += static_cast<char>((value_ >> shift) & 0xFF);
+        }
+        return text;
+    }
+
+    friend bool operator==(IataCode a, IataCode b) { return a.value_ == b.value_; }
+    friend bool operator!=(IataCode a, IataCode b) { return a.value_ != b.value_; }
+    friend bool operator<(IataCode a, IataCode b) { return a.value_ < b.value_; }
+
+private:
+    uint32_t value_ = 0;
+};
+
+// Multiplicative hash: packed codes differ mostly in their high bytes, so
+// fold the high half of the product back into the low bits the bucket
+// index is taken from
+struct IataCodeHash {
+    size_t operator()(IataCode code) const {
+        uint64_t h = static_cast<uint64_t>(code.raw()) * 0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+template <typename T>
+using IataMap = std::unordered_map<IataCode, T, IataCodeHash>;
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef ITINERARY_SEARCH_H
+#define ITINERARY_SEARCH_H
+
+#include "csr_index.h"
+#include "great_circle.h"
+#include "iata_code.h"
+#include "reachability_index.h"
+#include "route_table.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+struct ItineraryQuery {
+    enum class Order {
+        kShortest,    // least total distance
+        kFewestLegs,  // fewest legs, then least distance
+    };
+
+    Order order = Order::kShortest;
+    size_t max_legs = 3;
+    // Itineraries to return, best first
+    size_t limit = 5;
+    // Every leg flown by one airline
+    bool same_airline = false;
+    // Airports an itinerary may not pass through
+    std::vector<IataCode> excluded;
+};
+
+struct ItineraryLeg {
+    IataCode from;
+    IataCode to;
+    // Airlines flying the leg, in code order; just the itinerary's airline
+    // when the query asks for the same airline throughout
+    std::vector<IataCode> airlines;
+    double miles = 0.0;
+};
+
+struct Itinerary {
+    std::vector<ItineraryLeg> legs;
+    double miles = 0.0;
+};
+
+struct ItineraryResult {
+    // Best first
+    std::vector<Itinerary> itineraries;
+    // The search hit ItinerarySearch::kMaxNodes before finding `limit`
+    // itineraries. Those returned are still the best ones, in order, but
+    // more may exist.
+    bool truncated = false;
+};
+
+// Best-first search for the top itineraries between two airports over the
+// airport graph (parallel routes between two airports are one edge).
+// Itineraries never revisit an airport. Partial itineraries are expanded
+// in order of a lower bound on the cost of any itinerary that completes
+// them: distance so far plus the great-circle distance still to go, and
+// legs so far plus the fewest flights still needed, read from the
+// ReachabilityIndex. Distance order compares the distance bound first,
+// fewest-legs order the legs bound; each is exact once an itinerary is
+// complete and never overestimates before, so complete itineraries come
+// off the queue best first (A*) and the search stops after `limit` of
+// them. A partial itinerary that cannot reach the destination within
+// max_legs is never queued.
+//
+// There is no per-airport pruning: two partial itineraries that reach one
+// airport can differ in which airports they may still visit, so neither
+// makes the other redundant. The total work is instead capped at kMaxNodes
+// partial itineraries, and a search that hits the cap says so.
+class ItinerarySearch {
+public:
+    static const size_t kMaxNodes = 1 << 20;
+
+    // positions has one entry per dense airport index. usable(airport) is
+    // false for airports an itinerary may not touch, e.g. ones missing
+    // from airports.dat; reachability must be built with the same rule.
+    ItinerarySearch(const RouteTable& routes, const CsrIndex& routes_by_source,
+                    const std::vector<GeoPoint>& positions,
+                    const ReachabilityIndex& reachability,
+                    std::function<bool(uint32_t)> usable);
+
+    ItineraryResult find(IataCode source, IataCode dest, const ItineraryQuery& query) const;
+
+private:
+    // One partial itinerary, linked to the one it extends
+    struct Node {
+        uint32_t airport;
+        uint32_t airline;  // CodeDictionary::kNone unless same-airline
+        uint32_t parent;
+        uint32_t legs;
+        double miles;
+    };
+
+    static bool visits(const std::vector<Node>& nodes, uint32_t node, uint32_t airport);
+    Itinerary build(const std::vector<Node>& nodes, uint32_t node) const;
+
+    const RouteTable& routes_;
+    const CsrIndex& routes_by_source_;
+    const std::vector<GeoPoint>& positions_;
+    const ReachabilityIndex& reachability_;
+    std::function<bool(uint32_t)> usable_;
+};
+
+#endif
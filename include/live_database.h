@@ -0,0 +1,72 @@
+#ifndef LIVE_DATABASE_H
+#define LIVE_DATABASE_H
+
+#include "database.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// The Database instance currently serving requests. Starts empty while the
+// data is loading; publish() makes a fully built Database visible to all
+// request threads at once. Handlers take their own reference with
+// acquire(), so a request always runs against one complete instance and
+// an instance is freed only after the last request using it finishes.
+//
+// Published instances are never modified. Writes go through update(),
+// which applies them to a private copy and publishes that copy if they
+// succeed.
+class LiveDatabase {
+public:
+    std::shared_ptr<Database> acquire() const {
+        return std::atomic_load(&current_);
+    }
+
+    void publish(std::shared_ptr<Database> db) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        store(std::move(db));
+    }
+
+    // Copy-on-write update. fn(Database&) edits a private copy and returns
+    // whether to publish it; on false the copy is discarded. Writers are
+    // serialized with each other and with publish(); readers are never
+    // blocked. Returns false when no database has been published yet.
+    //
+    // Every call copies the whole Database, tables and indexes alike
+    // (about 11 ms on the bundled OpenFlights data), which suits the
+    // occasional admin write but not a sustained write load.
+    template <typename Fn>
+    bool update(Fn&& fn) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        std::shared_ptr<Database> current = acquire();
+        if (!current) {
+            return false;
+        }
+        auto next = std::make_shared<Database>(*current);
+        if (fn(*next)) {
+            store(std::move(next));
+        }
+        return true;
+    }
+
+    bool ready() const {
+        return acquire() != nullptr;
+    }
+
+    // Number of instances published so far (1 after the initial load)
+    uint64_t generation() const {
+        return generation_.load(std::memory_order_relaxed);
+    }
+
+private:
+    void store(std::shared_ptr<Database> db) {
+        std::atomic_store(&current_, std::move(db));
+        generation_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::shared_ptr<Database> current_;
+    std::mutex write_mutex_;
+    std::atomic<uint64_t> generation_{0};
+};
+
+#endif
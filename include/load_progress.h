@@ -0,0 +1,26 @@
+#ifndef LOAD_PROGRESS_H
+#define LOAD_PROGRESS_H
+
+#include <atomic>
+#include <cstdint>
+
+// Counters the loaders publish while a Database is being built. Loader
+// threads add to them with relaxed atomics; /readyz reads them at any time.
+struct LoadProgress {
+    std::atomic<uint64_t> bytes_total{0};
+    std::atomic<uint64_t> bytes_parsed{0};
+    std::atomic<uint64_t> airlines{0};
+    std::atomic<uint64_t> airports{0};
+    std::atomic<uint64_t> routes{0};
+
+    // Called before a reload reuses the same counters
+    void reset() {
+        bytes_total = 0;
+        bytes_parsed = 0;
+        airlines = 0;
+        airports = 0;
+        routes = 0;
+    }
+};
+
+#endif
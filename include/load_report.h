@@ -0,0 +1,129 @@
+#ifndef LOAD_REPORT_H
+#define LOAD_REPORT_H
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Where one Database load spent its time, and what happened to every row.
+// Filled in by the loader, then published read-only for /admin/load-report.
+struct LoadReport {
+    // CPU-time phases, summed over all loader threads
+    enum Phase { kFileIO, kSplit, kDecode, kInsert, kIndex, kPhaseCount };
+
+    // Rows kept per table and why the others were dropped
+    struct TableStats {
+        uint64_t accepted = 0;
+        uint64_t short_rows = 0;    // Fewer columns than the schema needs
+        uint64_t missing_code = 0;  // A required IATA code is empty or \N
+        uint64_t invalid_id = 0;    // Id missing or not positive
+    };
+
+    // Wall-clock step, with the process peak RSS when it finished (one
+    // getrusage() per step, a handful per load)
+    struct Step {
+        std::string name;
+        double wall_ms;
+        long peak_rss_kb;
+    };
+
+    std::string source; // "csv" or "snapshot"
+    TableStats airlines;
+    TableStats airports;
+    TableStats routes;
+    uint64_t phase_ns[kPhaseCount] = {};
+    std::vector<Step> steps;
+
+    void addStep(const std::string& name, std::chrono::steady_clock::duration wall);
+    std::string toJSON() const;
+    void print(std::ostream& out) const;
+
+    static const char* phaseName(Phase phase);
+};
+
+// Per-thread stopwatch: each lap charges the time since the previous lap
+// to one phase. A disabled clock never reads the time.
+//
+// Timing every CSV row would take several clock reads per row, so row
+// loops are bracketed with beginRows() / endRows() and call nextRow() per
+// row: only one row in kRowSample is timed, and endRows() splits the time
+// of the whole loop between phases in the proportions of the timed rows.
+class PhaseClock {
+public:
+    // Odd stride, so sampled rows do not line up with the power-of-two
+    // sizes at which vectors reallocate
+    static const uint32_t kRowSample = 61;
+
+    explicit PhaseClock(bool enabled) : enabled_(enabled) {
+        if (enabled_) last_ = std::chrono::steady_clock::now();
+    }
+
+    // Drops the time since the last lap, e.g. time spent waiting on workers
+    void restart() {
+        if (enabled_) last_ = std::chrono::steady_clock::now();
+    }
+
+    void lap(LoadReport::Phase phase) {
+        if (!enabled_ || (in_rows_ && !timing_row_)) return;
+        auto now = std::chrono::steady_clock::now();
+        uint64_t ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_).count());
+        (in_rows_ ? row_ns_ : ns_)[phase] += ns;
+        last_ = now;
+    }
+
+    void beginRows() {
+        if (!enabled_) return;
+        restart();
+        rows_started_ = last_;
+        in_rows_ = true;
+        timing_row_ = false;
+        rows_ = 0;
+        for (uint64_t& ns : row_ns_) ns = 0;
+    }
+
+    void nextRow() {
+        if (!enabled_) return;
+        timing_row_ = rows_++ % kRowSample == 0;
+        if (timing_row_) last_ = std::chrono::steady_clock::now();
+    }
+
+    void endRows() {
+        if (!enabled_) return;
+        auto now = std::chrono::steady_clock::now();
+        uint64_t span = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - rows_started_).count());
+        uint64_t sampled = 0;
+        for (uint64_t ns : row_ns_) sampled += ns;
+        if (sampled == 0) {
+            // No row was timed: the loop only scanned for line ends
+            ns_[LoadReport::kSplit] += span;
+        } else {
+            for (int p = 0; p < LoadReport::kPhaseCount; ++p) {
+                ns_[p] += static_cast<uint64_t>(static_cast<double>(span) * row_ns_[p] / sampled);
+            }
+        }
+        in_rows_ = false;
+        last_ = now;
+    }
+
+    void mergeInto(LoadReport& report) const {
+        for (int p = 0; p < LoadReport::kPhaseCount; ++p) {
+            report.phase_ns[p] += ns_[p];
+        }
+    }
+
+private:
+    bool enabled_;
+    bool in_rows_ = false;
+    bool timing_row_ = false;
+    uint64_t rows_ = 0;
+    std::chrono::steady_clock::time_point last_;
+    std::chrono::steady_clock::time_point rows_started_;
+    uint64_t ns_[LoadReport::kPhaseCount] = {};
+    uint64_t row_ns_[LoadReport::kPhaseCount] = {};
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef MODELS_H
+#define MODELS_H
+
+#include <string>
+
+// One row of airlines.dat. id -1 means "not found" in lookups.
+struct Airline {
+    int id = -1;
+    std::string name;
+    std::string alias;
+    std::string iata;
+    std::string icao;
+    std::string callsign;
+    std::string country;
+    std::string active;
+};
+
+// One row of airports.dat. id -1 means "not found" in lookups.
+struct Airport {
+    int id = -1;
+    std::string name;
+    std::string city;
+    std::string country;
+    std::string iata;
+    std::string icao;
+    double latitude = 0.0;
+    double longitude = 0.0;
+    int altitude = 0;
+    double timezone = 0.0;
+    std::string dst;
+    std::string tz;
+    std::string type;
+    std::string source;
+};
+
+// One row of routes.dat. Airlines and airports are referenced by IATA code
+// and by id; a missing id is -1.
+struct Route {
+    std::string airline_iata;
+    int airline_id = -1;
+    std::string source_iata;
+    int source_id = -1;
+    std::string dest_iata;
+    int dest_id = -1;
+    std::string codeshare;
+    int stops = 0;
+    std::string equipment;
+};
+
+// Rows of the per-airline / per-airport route count reports
+struct AirportRouteCount {
+    Airport airport;
+    int route_count;
+    AirportRouteCount(const Airport& a, int c) : airport(a), route_count(c) {}
+};
+
+struct AirlineRouteCount {
+    Airline airline;
+    int route_count;
+    AirlineRouteCount(const Airline& a, int c) : airline(a), route_count(c) {}
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef REACHABILITY_INDEX_H
+#define REACHABILITY_INDEX_H
+
+#include "csr_index.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Which airports each airport reaches within 1..kMaxHops flights, as one
+// bitset over dense airport indices per (hops, airport). A pair query is a
+// few bit tests; the bitsets for h hops are the direct destinations OR'd
+// with the (h - 1)-hop bitsets of those destinations.
+//
+// Route writes update the bitsets in place, after the route indexes have
+// been patched: a new link from u to v adds v, and everything v reaches,
+// to the airports that reach u early enough; a removed link recomputes
+// only the airports that reach u within the bound (no shortest path to u
+// uses a link out of u, so those are exact). Writes that change many
+// links at once (airline and airport deletes, or an airport insert that
+// makes existing routes usable) rebuild instead, which is cheaper than one
+// update per link for a busy airport.
+class ReachabilityIndex {
+public:
+    static const uint32_t kMaxHops = 3;
+    static const uint32_t kUnreachable = UINT32_MAX;
+
+    // usable(airport) is false for airports an itinerary may not touch;
+    // they are never reached nor passed through
+    using Usable = std::function<bool(uint32_t)>;
+
+    // Number of airports covered
+    size_t size() const { return airports_; }
+
+    // Rebuilds every bitset from the forward adjacency, whose neighbor runs
+    // must be sorted. Large graphs build each level on several threads.
+    void build(const CsrIndex& routes_by_source, size_t airports, const Usable& usable);
+
+    // Fewest flights from one airport to another: 0 for the same airport,
+    // otherwise 1..kMaxHops, or kUnreachable beyond that
+    uint32_t hops(uint32_t from, uint32_t to) const;
+
+    // The bitsets, level by level, for snapshots. assign() takes them back
+    // for `airports` airports; false, leaving the index unchanged, when
+    // their size does not fit that count.
+    const std::vector<uint64_t>& bits() const { return bits_; }
+    bool assign(size_t airports, std::vector<uint64_t> bits);
+
+    // Covers airports up to `airports`; the new ones start with no links.
+    // Copies the bitsets into the wider rows, far cheaper than build().
+    void grow(size_t airports);
+
+    // After routes_by_source gained a link from -> to (both usable and
+    // below size()); a link that already existed changes nothing
+    void addLink(uint32_t from, uint32_t to);
+
+    // After routes_by_source lost its last link from `from` to some airport
+    void removeLink(uint32_t from, const CsrIndex& routes_by_source, const Usable& usable);
+
+private:
+    // Level l holds the airports reached within l + 1 flights
+    uint64_t* row(uint32_t level, uint32_t airport) {
+        return bits_.data() + (level * airports_ + airport) * words_;
+    }
+    const uint64_t* row(uint32_t level, uint32_t airport) const {
+        return bits_.data() + (level * airports_ + airport) * words_;
+    }
+    bool reaches(uint32_t level, uint32_t from, uint32_t to) const {
+        return (row(level, from)[to / 64] >> (to % 64)) & 1;
+    }
+    // Flights from `from` to `to` below `levels` + 1, else kUnreachable
+    uint32_t distance(uint32_t from, uint32_t to, uint32_t levels) const;
+
+    void computeRow(uint32_t level, uint32_t airport, const CsrIndex& routes_by_source,
+                    const Usable& usable);
+
+    size_t airports_ = 0;
+    size_t words_ = 0;
+    std::vector<uint64_t> bits_;
+};
+
+#endif
@@ -0,0 +1,182 @@
+#ifndef RECORD_SCHEMA_H
+#define RECORD_SCHEMA_H
+
+#include "models.h"
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+// Schema-driven decoding of OpenFlights CSV rows.
+//
+// Each record type lists its columns once in a RecordSchema specialization:
+// which CSV column feeds which member, and which columns must be non-null
+// for the row to be kept. decodeRecord() is generated from that table, so
+// adding a dataset means adding a schema rather than another hand-written
+// parser. Columns that no schema entry names are never converted.
+
+namespace schema {
+
+// OpenFlights writes missing values as \N (and a few as N/A or empty)
+inline bool isNullField(std::string_view s) {
+    switch (s.size()) {
+        case 0: return true;
+        case 2: return std::memcmp(s.data(), "\\N", 2) == 0;
+        case 3: return std::memcmp(s.data(), "N/A", 3) == 0;
+        default: return false;
+    }
+}
+
+// std::from_chars rejects the leading blanks and '+' that std::stoi/std::stod
+// accept; strip them so both paths agree on every input.
+inline std::string_view trimNumber(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || (s.front() >= '\t' && s.front() <= '\r'))) {
+        s.remove_prefix(1);
+    }
+    if (s.size() > 1 && s.front() == '+' && s[1] != '-') {
+        s.remove_prefix(1);
+    }
+    return s;
+}
+
+// Numeric conversion via std::from_chars: no allocation, no exceptions.
+// Like std::stoi/std::stod, trailing characters after the number are ignored.
+inline int toInt(std::string_view s, int defaultVal) {
+    if (isNullField(s)) return defaultVal;
+    s = trimNumber(s);
+    int value;
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    return result.ec == std::errc() ? value : defaultVal;
+}
+
+// std::stod also reads hex ("0x1p3"), which from_chars only does when told
+// to and without the prefix. It reports a rounded subnormal result as out of
+// range (strtod sets ERANGE), so decimal subnormals, which never convert
+// exactly, fall back to the default; exact hex subnormals are kept.
+inline double toDouble(std::string_view s, double defaultVal) {
+    if (isNullField(s)) return defaultVal;
+    s = trimNumber(s);
+    bool negative = !s.empty() && s.front() == '-';
+    std::string_view digits = s.substr(negative ? 1 : 0);
+    double value;
+    if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        auto hex = std::from_chars(digits.data() + 2, digits.data() + digits.size(), value,
+                                   std::chars_format::hex);
+        if (hex.ec == std::errc()) {
+            return negative ? -value : value;
+        }
+    }
+    auto result = std::from_chars(s.data(), s.data() + s.size(), value);
+    if (result.ec != std::errc() || std::fpclassify(value) == FP_SUBNORMAL) {
+        return defaultVal;
+    }
+    return value;
+}
+
+inline void decodeField(std::string_view s, int& out) { out = toInt(s, -1); }
+inline void decodeField(std::string_view s, double& out) { out = toDouble(s, 0.0); }
+inline void decodeField(std::string_view s, std::string& out) {
+    if (isNullField(s)) {
+        out.clear();
+    } else {
+        out.assign(s.data(), s.size());
+    }
+}
+
+template <typename Record, typename T>
+struct Field {
+    size_t column;
+    T Record::*member;
+    bool required; // Row is dropped when this column is null
+};
+
+template <typename Record, typename T>
+constexpr Field<Record, T> field(size_t column, T Record::*member) {
+    return Field<Record, T>{column, member, false};
+}
+
+template <typename Record, typename T>
+constexpr Field<Record, T> required(size_t column, T Record::*member) {
+    return Field<Record, T>{column, member, true};
+}
+
+// Specialized per record type with kColumns (minimum row width) and fields
+template <typename Record>
+struct RecordSchema;
+
+template <>
+struct RecordSchema<Airline> {
+    static constexpr size_t kColumns = 8;
+    static constexpr auto fields = std::make_tuple(
+        field(0, &Airline::id),
+        field(1, &Airline::name),
+        field(2, &Airline::alias),
+        required(3, &Airline::iata),
+        field(4, &Airline::icao),
+        field(5, &Airline::callsign),
+        field(6, &Airline::country),
+        field(7, &Airline::active));
+};
+
+template <>
+struct RecordSchema<Airport> {
+    static constexpr size_t kColumns = 14;
+    static constexpr auto fields = std::make_tuple(
+        field(0, &Airport::id),
+        field(1, &Airport::name),
+        field(2, &Airport::city),
+        field(3, &Airport::country),
+        required(4, &Airport::iata),
+        field(5, &Airport::icao),
+        field(6, &Airport::latitude),
+        field(7, &Airport::longitude),
+        field(8, &Airport::altitude),
+        field(9, &Airport::timezone),
+        field(10, &Airport::dst),
+        field(11, &Airport::tz),
+        field(12, &Airport::type),
+        field(13, &Airport::source));
+};
+
+template <>
+struct RecordSchema<Route> {
+    static constexpr size_t kColumns = 9;
+    static constexpr auto fields = std::make_tuple(
+        required(0, &Route::airline_iata),
+        field(1, &Route::airline_id),
+        required(2, &Route::source_iata),
+        field(3, &Route::source_id),
+        required(4, &Route::dest_iata),
+        field(5, &Route::dest_id),
+        field(6, &Route::codeshare),
+        field(7, &Route::stops),
+        field(8, &Route::equipment));
+};
+
+// Decodes one split row into record. Returns false, without touching
+// record, when the row is too short or a required column is null.
+template <typename Record>
+bool decodeRecord(const std::vector<std::string_view>& columns, Record& record) {
+    using Schema = RecordSchema<Record>;
+    if (columns.size() < Schema::kColumns) {
+        return false;
+    }
+    bool keep = std::apply([&](const auto&... f) {
+        return ((!f.required || !isNullField(columns[f.column])) && ...);
+    }, Schema::fields);
+    if (!keep) {
+        return false;
+    }
+    std::apply([&](const auto&... f) {
+        (decodeField(columns[f.column], record.*(f.member)), ...);
+    }, Schema::fields);
+    return true;
+}
+
+} // namespace schema
+
+#endif
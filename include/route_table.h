@@ -0,0 +1,131 @@
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include "iata_code.h"
+#include "models.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Assigns dense indices 0..size()-1 to keys in first-seen order
+template <typename Key, typename Hash = std::hash<Key>>
+class Dictionary {
+public:
+    static const uint32_t kNone = UINT32_MAX;
+
+    uint32_t intern(const Key& key) {
+        auto inserted = index_.emplace(key, static_cast<uint32_t>(keys_.size()));
+        if (inserted.second) {
+            keys_.push_back(key);
+        }
+        return inserted.first->second;
+    }
+
+    // kNone when key was never interned
+    uint32_t find(const Key& key) const {
+        auto it = index_.find(key);
+        return it == index_.end() ? kNone : it->second;
+    }
+
+    const Key& at(uint32_t index) const { return keys_[index]; }
+    size_t size() const { return keys_.size(); }
+
+private:
+    std::vector<Key> keys_;
+    std::unordered_map<Key, uint32_t, Hash> index_;
+};
+
+using CodeDictionary = Dictionary<IataCode, IataCodeHash>;
+
+// Column-oriented route storage. Airline and airport codes are interned
+// once, on insertion, into dense indices, so queries compare and count
+// 32-bit integers and a scan touches only the columns it reads. Route
+// structs are materialized only at the API boundary.
+class RouteTable {
+public:
+    // One route with every reference already resolved to a dense index
+    struct Row {
+        uint32_t airline;
+        uint32_t source;
+        uint32_t dest;
+        uint32_t equipment;
+        int32_t airline_id;
+        int32_t source_id;
+        int32_t dest_id;
+        uint8_t stops;
+        bool codeshare;
+    };
+
+    size_t size() const { return airline_.size(); }
+    void reserve(size_t n);
+
+    // Interns the route's codes and equipment; codes must fit an IataCode
+    void append(const Route& route);
+    // Indices in row must come from this table's dictionaries
+    void appendRow(const Row& row);
+
+    Route get(size_t i) const;
+    Row row(size_t i) const;
+    void set(size_t i, const Route& route);
+    void erase(size_t i);
+
+    // Removes every route for which pred(i) is true, keeping the order of
+    // the rest. Returns the number removed.
+    template <typename Pred>
+    size_t eraseIf(Pred pred) {
+        size_t kept = 0;
+        for (size_t i = 0; i < size(); ++i) {
+            if (!pred(i)) {
+                moveRow(kept++, i);
+            }
+        }
+        size_t removed = size() - kept;
+        resize(kept);
+        return removed;
+    }
+
+    uint32_t airline(size_t i) const { return airline_[i]; }
+    uint32_t source(size_t i) const { return source_[i]; }
+    uint32_t dest(size_t i) const { return dest_[i]; }
+    uint8_t stops(size_t i) const { return stops_[i]; }
+    // Great-circle length in miles; 0 until the owner measures the route
+    double miles(size_t i) const { return miles_[i]; }
+    void setMiles(size_t i, double miles) { miles_[i] = miles; }
+
+    const std::vector<uint32_t>& airlineColumn() const { return airline_; }
+    const std::vector<uint32_t>& sourceColumn() const { return source_; }
+    const std::vector<uint32_t>& destColumn() const { return dest_; }
+
+    // Dense index <-> code. Airport indices cover every code that appears
+    // as a source or destination, whether or not airports.dat has it.
+    const CodeDictionary& airlineCodes() const { return airline_codes_; }
+    const CodeDictionary& airportCodes() const { return airport_codes_; }
+    const Dictionary<std::string>& equipmentNames() const { return equipment_names_; }
+
+    uint32_t internAirline(IataCode code) { return airline_codes_.intern(code); }
+    uint32_t internAirport(IataCode code) { return airport_codes_.intern(code); }
+    uint32_t internEquipment(const std::string& name) { return equipment_names_.intern(name); }
+
+private:
+    void moveRow(size_t to, size_t from);
+    void resize(size_t n);
+
+    std::vector<uint32_t> airline_;
+    std::vector<uint32_t> source_;
+    std::vector<uint32_t> dest_;
+    std::vector<uint32_t> equipment_;
+    std::vector<int32_t> airline_id_;
+    std::vector<int32_t> source_id_;
+    std::vector<int32_t> dest_id_;
+    std::vector<uint8_t> stops_;
+    std::vector<uint8_t> codeshare_;
+    std::vector<double> miles_;
+
+    CodeDictionary airline_codes_;
+    CodeDictionary airport_codes_;
+    Dictionary<std::string> equipment_names_;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef SORTED_CODE_INDEX_H
+#define SORTED_CODE_INDEX_H
+
+#include "iata_code.h"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Codes in ascending order, each with the row it maps to, kept in two flat
+// parallel arrays: ordered iteration is a linear scan, a page is a slice
+// of rows(), and seeks are binary searches over packed uint32 codes.
+//
+// Single writes go straight into place (an append when the code sorts
+// last, as in a snapshot load). Bulk loads stage() their entries and
+// merge() them in one pass, so building the index is a sort rather than
+// one mid-array insert per row. Reads see staged entries only after
+// merge().
+class SortedCodeIndex {
+public:
+    size_t size() const { return codes_.size(); }
+    IataCode code(size_t i) const { return IataCode::fromRaw(codes_[i]); }
+    uint32_t row(size_t i) const { return rows_[i]; }
+    // Row ids in code order
+    const std::vector<uint32_t>& rows() const { return rows_; }
+
+    // Position of the first code not less than code
+    size_t lowerBound(IataCode code) const;
+    // Positions [first, last) of the codes starting with prefix, which is
+    // compared byte for byte (codes are stored as loaded, upper case)
+    std::pair<size_t, size_t> prefixRange(std::string_view prefix) const;
+
+    // Maps code to row, replacing any row it had
+    void set(IataCode code, uint32_t row);
+    void erase(IataCode code);
+
+    // Queues code -> row for the next merge(); a later entry for the same
+    // code wins
+    void stage(IataCode code, uint32_t row) { pending_.emplace_back(code.raw(), row); }
+    void merge();
+
+private:
+    std::vector<uint32_t> codes_;
+    std::vector<uint32_t> rows_;
+    std::vector<std::pair<uint32_t, uint32_t>> pending_;
+};
+
+#endif
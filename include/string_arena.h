@@ -0,0 +1,58 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// A string stored in a StringArena (or a snapshot's Strings section)
+struct StrRef {
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
+
+// Append-only character buffer holding many small strings back to back,
+// so a table's text lives in one allocation instead of one per field.
+// Strings are never moved or freed individually: replace() and release()
+// only count the old bytes as dead, and the owner rebuilds the arena
+// (keeping live strings only) once dead() outgrows the live text.
+// Views stay valid until the next add().
+class StringArena {
+public:
+    StrRef add(std::string_view text) {
+        if (text.empty()) {
+            return StrRef();
+        }
+        StrRef ref{static_cast<uint32_t>(data_.size()), static_cast<uint32_t>(text.size())};
+        data_.append(text.data(), text.size());
+        return ref;
+    }
+
+    // Keeps old when it already holds text
+    StrRef replace(StrRef old, std::string_view text) {
+        if (view(old) == text) {
+            return old;
+        }
+        release(old);
+        return add(text);
+    }
+
+    void release(StrRef ref) { dead_ += ref.length; }
+
+    std::string_view view(StrRef ref) const {
+        return std::string_view(data_.data() + ref.offset, ref.length);
+    }
+
+    // Bytes stored, live and dead
+    size_t size() const { return data_.size(); }
+    size_t dead() const { return dead_; }
+    const std::string& data() const { return data_; }
+    void reserve(size_t n) { data_.reserve(n); }
+
+private:
+    std::string data_;
+    size_t dead_ = 0;
+};
+
+#endif
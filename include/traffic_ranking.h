@@ -0,0 +1,54 @@
+#ifndef TRAFFIC_RANKING_H
+#define TRAFFIC_RANKING_H
+
+#include "flat_code_map.h"
+#include "iata_code.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Airports in traffic order, kept materialized so a "top K" read is the
+// first K entries. Entries are ordered by route count descending, then by
+// code. A write that changes one airport's counts moves that entry up or
+// down to its new rank, which costs the number of entries it passes
+// rather than a full re-sort.
+class TrafficRanking {
+public:
+    struct Entry {
+        uint32_t code;      // packed IataCode
+        uint32_t routes;    // routes from or to the airport
+        uint32_t airlines;  // distinct airlines flying them
+    };
+
+    size_t size() const { return entries_.size(); }
+    // Highest traffic first
+    const std::vector<Entry>& entries() const { return entries_; }
+
+    // Replaces the ranking; one entry per code, in any order
+    void build(std::vector<Entry> entries);
+    // Replaces the ranking with entries already in rank order, as
+    // entries() returns them (e.g. from a snapshot); false, leaving the
+    // ranking unchanged, when they are not
+    bool assign(std::vector<Entry> ranked);
+    // Inserts or updates the entry for entry.code and moves it to its rank
+    void set(const Entry& entry);
+    void erase(IataCode code);
+
+private:
+    static bool before(const Entry& a, const Entry& b) {
+        if (a.routes != b.routes) {
+            return a.routes > b.routes;
+        }
+        return a.code < b.code;
+    }
+
+    // Points positions_ at every entry
+    void indexPositions();
+    void swapEntries(size_t i, size_t j);
+
+    std::vector<Entry> entries_;
+    // Code -> position in entries_
+    FlatCodeMap positions_;
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+#include "flat_code_map.h"
+#include "iata_code.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Case-insensitive substring search over the codes and names of one
+// entity table, for autocomplete. Both are lowercased once, when stored.
+// Every three-character window of either one is a trigram with a posting
+// list of the codes containing it, sorted, so the candidates for a query
+// are the intersection of its trigrams' lists; candidates are then checked
+// for the whole query. Queries shorter than a trigram scan the stored
+// lowercase text instead.
+//
+// Matches rank as the search box always has: exact code first, then code
+// prefix, then name prefix, then alphabetical by code, each rule only
+// ordering ties of the ones before.
+// Case folding is ASCII only, like ::tolower in the C locale.
+class TrigramIndex {
+public:
+    size_t size() const { return docs_.size(); }
+    void clear();
+
+    // Indexes code with name, replacing what code had
+    void set(IataCode code, std::string_view name);
+    void erase(IataCode code);
+
+    // Like set() for bulk loads, on an index without code: the postings
+    // are sorted once, by merge(). Searches need a merge() first.
+    void stage(IataCode code, std::string_view name);
+    void merge();
+
+    // The best `limit` codes whose code or name contains query
+    std::vector<IataCode> search(std::string_view query, size_t limit) const;
+
+    // Trigram -> codes containing it, ascending
+    using Postings = std::unordered_map<uint32_t, std::vector<uint32_t>>;
+
+    // The contents, for snapshots: each slot's code and lowercase name,
+    // and the posting lists. assign() takes them back as they are; it
+    // returns false, leaving the index unchanged, when a code repeats or a
+    // posting list is unsorted or names a code with no doc.
+    IataCode docCode(size_t slot) const { return docs_[slot].code; }
+    const std::string& docName(size_t slot) const { return docs_[slot].name; }
+    const Postings& postings() const { return postings_; }
+    bool assign(std::vector<std::pair<IataCode, std::string>> docs, Postings postings);
+
+private:
+    struct Doc {
+        IataCode code;
+        std::string code_text;  // lowercase
+        std::string name;       // lowercase
+    };
+
+    // Trigrams of the doc's code and name, once each
+    static std::vector<uint32_t> trigrams(const Doc& doc);
+    void add(IataCode code, std::string_view name, bool sorted);
+
+    std::vector<Doc> docs_;
+    FlatCodeMap doc_of_;
+    Postings postings_;
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "../include/count_matrix.h"
+
+void CountMatrix::appendRow(std::vector<uint32_t>& counts, std::vector<uint32_t>& touched) {
+    size_t first = cells_.size();
+    for (uint32_t col : touched) {
+        cells_.push_back(CountCell{col, counts[col]});
+        counts[col] = 0;
+    }
+    touched.clear();
+
+    std::sort(cells_.begin() + first, cells_.end(), [this](const CountCell& a, const CountCell& b) {
+        return before(a, b);
+    });
+    offsets_.push_back(static_cast<uint32_t>(cells_.size()));
+}
+
+size_t CountMatrix::find(uint32_t r, uint32_t col) const {
+    size_t i = offsets_[r];
+    while (i < offsets_[r + 1] && cells_[i].col != col) {
+        ++i;
+    }
+    return i;
+}
+
+void CountMatrix::increment(uint32_t r, uint32_t col, uint32_t order) {
+    if (col >= col_order_.size()) {
+        col_order_.resize(static_cast<size_t>(col) + 1, 0);
+    }
+    col_order_[col] = order;
+    if (offsets_.empty()) {
+        offsets_.assign(1, 0);
+    }
+    if (r >= rowCount()) {
+        offsets_.resize(static_cast<size_t>(r) + 2, offsets_.back());
+    }
+
+    size_t first = offsets_[r];
+    size_t i = find(r, col);
+    if (i == offsets_[r + 1]) {
+        cells_.insert(cells_.begin() + i, CountCell{col, 0});
+        for (size_t k = static_cast<size_t>(r) + 1; k < offsets_.size(); ++k) {
+            ++offsets_[k];
+        }
+    }
+    ++cells_[i].count;
+    for (; i > first && before(cells_[i], cells_[i - 1]); --i) {
+        std::swap(cells_[i], cells_[i - 1]);
+    }
+}
+
+void CountMatrix::decrement(uint32_t r, uint32_t col) {
+    if (r >= rowCount()) {
+        return;
+    }
+    size_t last = offsets_[r + 1];
+    size_t i = find(r, col);
+    if (i == last) {
+        return;
+    }
+    if (--cells_[i].count == 0) {
+        cells_.erase(cells_.begin() + i);
+        for (size_t k = static_cast<size_t>(r) + 1; k < offsets_.size(); ++k) {
+            --offsets_[k];
+        }
+        return;
+    }
+    for (; i + 1 < last && before(cells_[i + 1], cells_[i]); ++i) {
+        std::swap(cells_[i], cells_[i + 1]);
+    }
+}
+
+bool CountMatrix::assign(std::vector<uint32_t> offsets, std::vector<CountCell> cells,
+                         std::vector<uint32_t> col_order, size_t col_count) {
+    if (offsets.empty() || offsets.front() != 0 || offsets.back() != cells.size() ||
+        col_order.size() > col_count || !std::is_sorted(offsets.begin(), offsets.end())) {
+        return false;
+    }
+    for (const CountCell& cell : cells) {
+        if (cell.col >= col_order.size()) {
+            return false;
+        }
+    }
+    offsets_ = std::move(offsets);
+    cells_ = std::move(cells);
+    col_order_ = std::move(col_order);
+    return true;
+}
@@ -0,0 +1,172 @@
+#include "../include/csr_index.h"
+
+namespace {
+
+// Row ids 0..values.size()-1 in ascending (value, row) order, by counting
+// sort
+std::vector<uint32_t> countingOrder(const std::vector<uint32_t>& values) {
+    uint32_t max_value = 0;
+    for (uint32_t value : values) {
+        max_value = std::max(max_value, value);
+    }
+    std::vector<uint32_t> next(static_cast<size_t>(max_value) + 2, 0);
+    for (uint32_t value : values) {
+        ++next[value + 1];
+    }
+    for (size_t v = 0; v + 1 < next.size(); ++v) {
+        next[v + 1] += next[v];
+    }
+    std::vector<uint32_t> order(values.size());
+    for (size_t row = 0; row < values.size(); ++row) {
+        order[next[values[row]]++] = static_cast<uint32_t>(row);
+    }
+    return order;
+}
+
+} // namespace
+
+void CsrIndex::build(const std::vector<uint32_t>& keys, size_t key_count) {
+    build(keys, key_count, nullptr);
+}
+
+void CsrIndex::build(const std::vector<uint32_t>& keys, size_t key_count,
+                     const std::vector<uint32_t>& neighbors) {
+    build(keys, key_count, &neighbors);
+}
+
+void CsrIndex::build(const std::vector<uint32_t>& keys, size_t key_count,
+                     const std::vector<uint32_t>* neighbors) {
+    has_neighbors_ = neighbors != nullptr;
+
+    // Count rows per key, then turn the counts into start offsets
+    offsets_.assign(key_count + 1, 0);
+    for (uint32_t key : keys) {
+        ++offsets_[key + 1];
+    }
+    for (size_t k = 0; k < key_count; ++k) {
+        offsets_[k + 1] += offsets_[k];
+    }
+
+    // Scatter rows in ascending row order, or in (neighbor, row) order when
+    // there is a neighbor column; the scatter is stable, so each key's run
+    // keeps that order
+    std::vector<uint32_t> order;
+    if (has_neighbors_) {
+        order = countingOrder(*neighbors);
+    }
+    std::vector<uint32_t> next(offsets_.begin(), offsets_.end() - 1);
+    rows_.resize(keys.size());
+    neighbors_.resize(has_neighbors_ ? keys.size() : 0);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        uint32_t row = has_neighbors_ ? order[i] : static_cast<uint32_t>(i);
+        uint32_t slot = next[keys[row]]++;
+        rows_[slot] = row;
+        if (has_neighbors_) {
+            neighbors_[slot] = (*neighbors)[row];
+        }
+    }
+}
+
+size_t CsrIndex::position(uint32_t key, uint32_t row, uint32_t neighbor) const {
+    size_t low = offsets_[key];
+    size_t high = offsets_[key + 1];
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        bool before = has_neighbors_ && neighbors_[mid] != neighbor ? neighbors_[mid] < neighbor
+                                                                     : rows_[mid] < row;
+        if (before) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void CsrIndex::insert(uint32_t key, uint32_t row, uint32_t neighbor) {
+    if (offsets_.empty()) {
+        offsets_.assign(1, 0);
+    }
+    if (key >= keyCount()) {
+        offsets_.resize(static_cast<size_t>(key) + 2, offsets_.back());
+    }
+    size_t at = position(key, row, neighbor);
+    rows_.insert(rows_.begin() + at, row);
+    if (has_neighbors_) {
+        neighbors_.insert(neighbors_.begin() + at, neighbor);
+    }
+    for (size_t k = static_cast<size_t>(key) + 1; k < offsets_.size(); ++k) {
+        ++offsets_[k];
+    }
+}
+
+void CsrIndex::erase(uint32_t key, uint32_t row, uint32_t neighbor) {
+    if (key >= keyCount()) {
+        return;
+    }
+    size_t at = position(key, row, neighbor);
+    if (at == offsets_[key + 1] || rows_[at] != row) {
+        return;
+    }
+    rows_.erase(rows_.begin() + at);
+    if (has_neighbors_) {
+        neighbors_.erase(neighbors_.begin() + at);
+    }
+    for (size_t k = static_cast<size_t>(key) + 1; k < offsets_.size(); ++k) {
+        --offsets_[k];
+    }
+}
+
+void CsrIndex::eraseRows(const std::vector<uint32_t>& erased) {
+    if (erased.empty()) {
+        return;
+    }
+    // Compact every run in place; renumbering keeps each run's order
+    size_t kept = 0;
+    size_t first = 0;
+    for (size_t k = 0; k < keyCount(); ++k) {
+        size_t last = offsets_[k + 1];
+        for (size_t i = first; i < last; ++i) {
+            auto below = std::lower_bound(erased.begin(), erased.end(), rows_[i]);
+            if (below != erased.end() && *below == rows_[i]) {
+                continue;
+            }
+            rows_[kept] = rows_[i] - static_cast<uint32_t>(below - erased.begin());
+            if (has_neighbors_) {
+                neighbors_[kept] = neighbors_[i];
+            }
+            ++kept;
+        }
+        first = last;
+        offsets_[k + 1] = static_cast<uint32_t>(kept);
+    }
+    rows_.resize(kept);
+    if (has_neighbors_) {
+        neighbors_.resize(kept);
+    }
+}
+
+bool CsrIndex::assign(std::vector<uint32_t> offsets, std::vector<uint32_t> rows,
+                      std::vector<uint32_t> neighbors, bool has_neighbors, size_t row_count,
+                      size_t neighbor_count) {
+    if (offsets.empty() || offsets.front() != 0 || offsets.back() != rows.size() ||
+        neighbors.size() != (has_neighbors ? rows.size() : 0) ||
+        !std::is_sorted(offsets.begin(), offsets.end())) {
+        return false;
+    }
+    for (uint32_t row : rows) {
+        if (row >= row_count) {
+            return false;
+        }
+    }
+    for (uint32_t neighbor : neighbors) {
+        if (neighbor >= neighbor_count) {
+            return false;
+        }
+    }
+    offsets_ = std::move(offsets);
+    rows_ = std::move(rows);
+    neighbors_ = std::move(neighbors);
+    has_neighbors_ = has_neighbors;
+    return true;
+}
@@ -0,0 +1,227 @@
+#include "../include/csv_parser.h"
+#include "../include/record_schema.h"
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define CSV_PARSER_X86 1
+#endif
+
+using namespace std;
+
+namespace {
+
+// Structural character scan (stage 1 of parseLine). A kernel sets bit i of
+// masks[i / 64] for every ',' or '"' in data[0..size); masks arrive zeroed.
+using StructuralKernel = void (*)(const char* data, size_t size, uint64_t* masks);
+
+// Scalar marking of data[begin..size); also finishes the SIMD kernels' tails
+void markStructural(const char* data, size_t begin, size_t size, uint64_t* masks) {
+    for (size_t i = begin; i < size; ++i) {
+        char c = data[i];
+        if (c == ',' || c == '"') {
+            masks[i >> 6] |= uint64_t(1) << (i & 63);
+        }
+    }
+}
+
+void structuralMasksScalar(const char* data, size_t size, uint64_t* masks) {
+    markStructural(data, 0, size, masks);
+}
+
+#ifdef CSV_PARSER_X86
+__attribute__((target("sse2")))
+void structuralMasksSSE2(const char* data, size_t size, uint64_t* masks) {
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, comma), _mm_cmpeq_epi8(block, quote));
+        uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+        masks[i >> 6] |= uint64_t(bits) << (i & 63);
+    }
+    markStructural(data, i, size, masks);
+}
+
+__attribute__((target("avx2")))
+void structuralMasksAVX2(const char* data, size_t size, uint64_t* masks) {
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i quote = _mm256_set1_epi8('"');
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i hits = _mm256_or_si256(_mm256_cmpeq_epi8(block, comma), _mm256_cmpeq_epi8(block, quote));
+        uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+        masks[i >> 6] |= uint64_t(bits) << (i & 63);
+    }
+    markStructural(data, i, size, masks);
+}
+#endif
+
+// Picks the widest kernel the CPU supports. AIRTRAVEL_CSV_KERNEL=scalar|sse2
+// forces a narrower one (useful when comparing outputs across kernels);
+// avx2, like no setting, means the widest available.
+StructuralKernel selectStructuralKernel() {
+    const char* forced = std::getenv("AIRTRAVEL_CSV_KERNEL");
+    std::string choice = forced ? forced : "";
+    if (choice == "scalar") {
+        return structuralMasksScalar;
+    }
+#ifdef CSV_PARSER_X86
+    __builtin_cpu_init();
+    if (choice != "sse2" && __builtin_cpu_supports("avx2")) {
+        return structuralMasksAVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return structuralMasksSSE2;
+    }
+#endif
+    return structuralMasksScalar;
+}
+
+} // namespace
+
+std::vector<std::string> CSVParser::parseLine(const std::string& line) {
+    FieldBuffer buffer;
+    const auto& views = parseLine(std::string_view(line), buffer);
+    return std::vector<std::string>(views.begin(), views.end());
+}
+
+const std::vector<std::string_view>& CSVParser::parseLine(std::string_view line, FieldBuffer& buffer) {
+    auto& fields = buffer.fields;
+    auto& scratch = buffer.scratch;
+    fields.clear();
+    scratch.clear();
+    // Unescaped text is never longer than the line itself, so reserving up
+    // front keeps views into scratch valid while the line is split.
+    if (scratch.capacity() < line.size()) {
+        scratch.reserve(line.size());
+    }
+
+    size_t fieldStart = 0;
+    size_t quoteCount = 0;
+    bool inQuotes = false;
+
+    auto finishField = [&](size_t fieldEnd) {
+        std::string_view raw = line.substr(fieldStart, fieldEnd - fieldStart);
+        if (quoteCount == 0) {
+            fields.push_back(raw);
+        } else if (quoteCount == 2 && raw.size() >= 2 && raw.front() == '"' && raw.back() == '"') {
+            // Plain quoted field: the content is a contiguous slice of the line
+            fields.push_back(raw.substr(1, raw.size() - 2));
+        } else {
+            // Escaped or embedded quotes: unescape into scratch
+            size_t begin = scratch.size();
+            bool q = false;
+            for (size_t i = 0; i < raw.size(); ++i) {
+                char c = raw[i];
+                if (c == '"') {
+                    if (q && i + 1 < raw.size() && raw[i + 1] == '"') {
+                        scratch += '"';
+                        ++i;
+                    } else {
+                        q = !q;
+                    }
+                } else {
+                    scratch += c;
+                }
+            }
+            fields.push_back(std::string_view(scratch.data() + begin, scratch.size() - begin));
+        }
+    };
+
+    // Stage 1: mark every comma and quote with the vectorized kernel
+    static const StructuralKernel kernel = selectStructuralKernel();
+    auto& masks = buffer.masks;
+    size_t words = (line.size() + 63) / 64;
+    masks.assign(words, 0);
+    kernel(line.data(), line.size(), masks.data());
+
+    // Stage 2: walk only the marked positions, applying the same quote rules
+    // as the character-at-a-time parser
+    size_t resume = 0; // first position not consumed by an escaped quote
+    for (size_t w = 0; w < words; ++w) {
+        uint64_t bits = masks[w];
+        while (bits) {
+            size_t i = w * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+            bits &= bits - 1;
+            if (i < resume) continue;
+
+            if (line[i] == '"') {
+                if (inQuotes && i + 1 < line.size() && line[i + 1] == '"') {
+                    // Escaped quote
+                    quoteCount += 2;
+                    resume = i + 2;
+                } else {
+                    // Toggle quote state
+                    inQuotes = !inQuotes;
+                    ++quoteCount;
+                }
+            } else if (!inQuotes) {
+                finishField(i);
+                fieldStart = i + 1;
+                quoteCount = 0;
+            }
+        }
+    }
+    finishField(line.size()); // Last field
+
+    return fields;
+}
+
+bool CSVParser::isNull(std::string_view s) {
+    return schema::isNullField(s);
+}
+
+int CSVParser::parseInt(std::string_view s, int defaultVal) {
+    return schema::toInt(s, defaultVal);
+}
+
+double CSVParser::parseDouble(std::string_view s, double defaultVal) {
+    return schema::toDouble(s, defaultVal);
+}
+
+std::string CSVParser::cleanString(std::string_view s) {
+    return schema::isNullField(s) ? std::string() : std::string(s);
+}
+
+Airline CSVParser::parseAirline(const std::string& line) {
+    FieldBuffer buffer;
+    return parseAirline(parseLine(std::string_view(line), buffer));
+}
+
+Airline CSVParser::parseAirline(const std::vector<std::string_view>& fields) {
+    // Rows that are too short or lack an IATA code come back default-constructed
+    Airline airline;
+    schema::decodeRecord(fields, airline);
+    return airline;
+}
+
+Airport CSVParser::parseAirport(const std::string& line) {
+    FieldBuffer buffer;
+    return parseAirport(parseLine(std::string_view(line), buffer));
+}
+
+Airport CSVParser::parseAirport(const std::vector<std::string_view>& fields) {
+    // Rows that are too short or lack an IATA code come back default-constructed
+    Airport airport;
+    schema::decodeRecord(fields, airport);
+    return airport;
+}
+
+Route CSVParser::parseRoute(const std::string& line) {
+    FieldBuffer buffer;
+    return parseRoute(parseLine(std::string_view(line), buffer));
+}
+
+Route CSVParser::parseRoute(const std::vector<std::string_view>& fields) {
+    // Rows that are too short or lack an IATA code come back default-constructed
+    Route route;
+    schema::decodeRecord(fields, route);
+    return route;
+}
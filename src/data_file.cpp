@@ -0,0 +1,291 @@
+#include "../include/data_file.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <sys/stat.h>
+#ifdef AIRTRAVEL_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef AIRTRAVEL_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+// Pulls decompressed bytes from one file. read() returns the number of
+// bytes written to out, 0 at the end of the input, or -1 on an error
+// (including input that ends in the middle of a compressed stream).
+class StreamDecoder {
+public:
+    virtual ~StreamDecoder() = default;
+    virtual long read(char* out, size_t capacity) = 0;
+};
+
+namespace {
+
+// Decompressed bytes per block handed to the parser
+const size_t kBlockBytes = 4 << 20;
+
+// Blocks decompressed ahead of the parser; bounds memory use
+const size_t kMaxQueuedBlocks = 4;
+
+bool endsWith(const std::string& s, const char* suffix) {
+    size_t n = std::strlen(suffix);
+    return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+#ifdef AIRTRAVEL_HAVE_ZLIB
+class GzipDecoder : public StreamDecoder {
+public:
+    explicit GzipDecoder(gzFile file) : file_(file) {
+        gzbuffer(file_, 256 * 1024);
+    }
+    ~GzipDecoder() override { gzclose(file_); }
+
+    long read(char* out, size_t capacity) override {
+        int n = gzread(file_, out, static_cast<unsigned>(std::min<size_t>(capacity, 1u << 30)));
+        if (n > 0) {
+            return n;
+        }
+        // gzread reports a truncated stream as a plain end of file
+        int err = Z_OK;
+        gzerror(file_, &err);
+        return (n < 0 || err != Z_OK) ? -1 : 0;
+    }
+
+private:
+    gzFile file_;
+};
+#endif
+
+#ifdef AIRTRAVEL_HAVE_ZSTD
+class ZstdDecoder : public StreamDecoder {
+public:
+    ZstdDecoder(FILE* file, ZSTD_DCtx* dctx)
+        : file_(file), dctx_(dctx), in_buf_(ZSTD_DStreamInSize()) {}
+    ~ZstdDecoder() override {
+        ZSTD_freeDCtx(dctx_);
+        std::fclose(file_);
+    }
+
+    long read(char* out, size_t capacity) override {
+        while (true) {
+            // A full output buffer may leave decoded bytes inside dctx_,
+            // so drain those before reading more input
+            if (in_.pos == in_.size && !flushing_) {
+                size_t n = std::fread(in_buf_.data(), 1, in_buf_.size(), file_);
+                if (n == 0) {
+                    // pending_ != 0 means the last frame never finished
+                    return (std::ferror(file_) || pending_ != 0) ? -1 : 0;
+                }
+                in_ = ZSTD_inBuffer{in_buf_.data(), n, 0};
+            }
+            ZSTD_outBuffer output{out, capacity, 0};
+            size_t ret = ZSTD_decompressStream(dctx_, &output, &in_);
+            if (ZSTD_isError(ret)) {
+                return -1;
+            }
+            pending_ = ret;
+            flushing_ = output.pos == output.size;
+            if (output.pos > 0) {
+                return static_cast<long>(output.pos);
+            }
+        }
+    }
+
+private:
+    FILE* file_;
+    ZSTD_DCtx* dctx_;
+    std::vector<char> in_buf_;
+    ZSTD_inBuffer in_{nullptr, 0, 0};
+    size_t pending_ = 0;
+    bool flushing_ = false;
+};
+#endif
+
+// Returns a decoder for a .gz or .zst file, or nullptr when the file cannot
+// be opened or this build lacks the library for its format
+std::unique_ptr<StreamDecoder> openDecoder([[maybe_unused]] const std::string& filename) {
+#ifdef AIRTRAVEL_HAVE_ZLIB
+    if (endsWith(filename, ".gz")) {
+        gzFile file = gzopen(filename.c_str(), "rb");
+        if (!file) {
+            return nullptr;
+        }
+        return std::unique_ptr<StreamDecoder>(new GzipDecoder(file));
+    }
+#endif
+#ifdef AIRTRAVEL_HAVE_ZSTD
+    if (endsWith(filename, ".zst")) {
+        FILE* file = std::fopen(filename.c_str(), "rb");
+        if (!file) {
+            return nullptr;
+        }
+        ZSTD_DCtx* dctx = ZSTD_createDCtx();
+        if (!dctx) {
+            std::fclose(file);
+            return nullptr;
+        }
+        return std::unique_ptr<StreamDecoder>(new ZstdDecoder(file, dctx));
+    }
+#endif
+    return nullptr;
+}
+
+} // namespace
+
+DataFile::~DataFile() {
+    close();
+}
+
+bool DataFile::open(const std::string& filename) {
+    close();
+
+    if (!endsWith(filename, ".gz") && !endsWith(filename, ".zst")) {
+        if (!mapped_.open(filename)) {
+            return false;
+        }
+        file_size_ = mapped_.size();
+        mapped_pending_ = true;
+        return true;
+    }
+
+    struct stat st;
+    if (::stat(filename.c_str(), &st) != 0) {
+        return false;
+    }
+    std::unique_ptr<StreamDecoder> decoder = openDecoder(filename);
+    if (!decoder) {
+        return false;
+    }
+    file_size_ = static_cast<size_t>(st.st_size);
+    compressed_ = true;
+    producer_ = std::thread(&DataFile::produce, this, std::move(decoder));
+    return true;
+}
+
+void DataFile::close() {
+    if (producer_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        space_cv_.notify_all();
+        producer_.join();
+    }
+    mapped_.close();
+    compressed_ = false;
+    mapped_pending_ = false;
+    file_size_ = 0;
+    ready_.clear();
+    current_.clear();
+    done_ = false;
+    error_ = false;
+    stop_ = false;
+}
+
+bool DataFile::next(std::string_view& block) {
+    if (!compressed_) {
+        if (!mapped_pending_) {
+            return false;
+        }
+        mapped_pending_ = false;
+        block = mapped_.view();
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    ready_cv_.wait(lock, [this] { return !ready_.empty() || done_; });
+    if (error_ || ready_.empty()) {
+        return false;
+    }
+    current_ = std::move(ready_.front());
+    ready_.pop_front();
+    space_cv_.notify_one();
+    block = current_;
+    return true;
+}
+
+bool DataFile::failed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return error_;
+}
+
+// Runs on producer_: inflates the input into blocks that end just after a
+// '\n' (the last block may not) and queues them for next(). The partial
+// line after the cut is carried into the following block, so every line
+// reaches the parser whole.
+void DataFile::produce(std::unique_ptr<StreamDecoder> decoder) {
+    bool ok = true;
+    bool eof = false;
+    std::string carry;
+    while (ok && !eof) {
+        std::string block = std::move(carry);
+        carry.clear();
+        size_t filled = block.size();
+        size_t line_end = 0; // One past the last '\n' read into this block
+        while (true) {
+            block.resize(filled + kBlockBytes);
+            long n = decoder->read(&block[filled], kBlockBytes);
+            if (n < 0) {
+                ok = false;
+                break;
+            }
+            if (n == 0) {
+                eof = true;
+                break;
+            }
+            const void* nl = memrchr(block.data() + filled, '\n', static_cast<size_t>(n));
+            filled += static_cast<size_t>(n);
+            if (nl) {
+                line_end = static_cast<size_t>(static_cast<const char*>(nl) - block.data()) + 1;
+            }
+            if (line_end > 0 && filled >= kBlockBytes) {
+                break;
+            }
+        }
+        if (!ok) {
+            break;
+        }
+        block.resize(filled);
+        if (!eof) {
+            carry.assign(block, line_end, std::string::npos);
+            block.resize(line_end);
+        }
+        if (block.empty()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        space_cv_.wait(lock, [this] { return stop_ || ready_.size() < kMaxQueuedBlocks; });
+        if (stop_) {
+            return;
+        }
+        ready_.push_back(std::move(block));
+        ready_cv_.notify_one();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_ = !ok;
+    done_ = true;
+    ready_cv_.notify_one();
+}
+
+std::string resolveDataFile(const std::string& filename) {
+    static const char* const kSuffixes[] = {
+        "",
+#ifdef AIRTRAVEL_HAVE_ZSTD
+        ".zst",
+#endif
+#ifdef AIRTRAVEL_HAVE_ZLIB
+        ".gz",
+#endif
+    };
+    struct stat st;
+    for (const char* suffix : kSuffixes) {
+        std::string candidate = filename + suffix;
+        if (::stat(candidate.c_str(), &st) == 0) {
+            return candidate;
+        }
+    }
+    return filename;
+}
@@ -0,0 +1,123 @@
+#include "../include/data_reloader.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+// Writers usually touch several files in a row; wait for them to settle
+static const int kWatchSettleMs = 500;
+
+DataReloader::DataReloader(LiveDatabase& live, LoadFn load)
+    : live_(live), load_(std::move(load)) {
+    worker_ = std::thread(&DataReloader::workerLoop, this);
+}
+
+DataReloader::~DataReloader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    worker_.join();
+    if (watcher_.joinable()) {
+        watcher_.join();
+    }
+    if (inotify_fd_ >= 0) {
+        close(inotify_fd_);
+    }
+}
+
+void DataReloader::requestReload() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requested_ = true;
+    }
+    wake_.notify_all();
+}
+
+void DataReloader::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this] { return requested_ || stopping_; });
+        if (stopping_) {
+            return;
+        }
+        requested_ = false;
+        reloading_ = true;
+        lock.unlock();
+
+        std::cout << "Reloading data files..." << std::endl;
+        std::shared_ptr<Database> fresh = load_();
+        if (fresh) {
+            live_.publish(std::move(fresh));
+            std::cout << "Reload complete (generation " << live_.generation() << ")" << std::endl;
+        } else {
+            ++failures_;
+            std::cerr << "Reload failed; still serving the previous data" << std::endl;
+        }
+
+        lock.lock();
+        reloading_ = false;
+    }
+}
+
+bool DataReloader::watch(const std::string& directory, const std::vector<std::string>& files) {
+    if (inotify_fd_ >= 0) {
+        return false;
+    }
+    int fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (fd < 0) {
+        return false;
+    }
+    // Directory watch so atomic replace-by-rename is seen as well as rewrites
+    if (inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(fd);
+        return false;
+    }
+    inotify_fd_ = fd;
+    watcher_ = std::thread(&DataReloader::watchLoop, this, fd, files);
+    return true;
+}
+
+void DataReloader::watchLoop(int fd, std::vector<std::string> files) {
+    alignas(inotify_event) char buffer[4096];
+    bool pending = false;
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                return;
+            }
+        }
+
+        // Wake periodically to notice shutdown; once a change is seen,
+        // wait for a quiet period before reloading.
+        pollfd pfd = {fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, pending ? kWatchSettleMs : 1000);
+        if (ready == 0) {
+            if (pending) {
+                pending = false;
+                requestReload();
+            }
+            continue;
+        }
+        if (ready < 0) {
+            continue;
+        }
+
+        ssize_t n;
+        while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (char* p = buffer; p < buffer + n; ) {
+                auto* event = reinterpret_cast<inotify_event*>(p);
+                if (event->len > 0 &&
+                    std::find(files.begin(), files.end(), std::string(event->name)) != files.end()) {
+                    pending = true;
+                }
+                p += sizeof(inotify_event) + event->len;
+            }
+        }
+    }
+}
@@ -0,0 +1,1377 @@
+#include "../include/database.h"
+#include "../include/csv_parser.h"
+#include "../include/data_file.h"
+#include "../include/record_schema.h"
+#include "../include/load_progress.h"
+#include "../include/load_report.h"
+#include "../include/route_table.h"
+#include "../include/csr_index.h"
+#include "../include/count_matrix.h"
+#include "../include/traffic_ranking.h"
+#include "../include/entity_table.h"
+#include "../include/great_circle.h"
+#include "../include/itinerary_search.h"
+#include "../include/reachability_index.h"
+#include "../include/trigram_index.h"
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+#include <cmath>
+#include <unordered_set>
+#include <unordered_map>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <chrono>
+
+using namespace std;
+
+namespace {
+
+// Bytes of input between progress counter updates
+const size_t kProgressStride = 1 << 20;
+
+// Calls fn for every non-empty, non-comment line of a loaded .dat file.
+// Lines are split on '\n' only, matching std::getline. fn returns true for
+// rows it kept; with a progress sink, bytes consumed and rows kept are
+// added to it roughly once per kProgressStride bytes.
+template <typename Fn>
+void forEachLine(std::string_view data, Fn&& fn, LoadProgress* progress = nullptr,
+                 std::atomic<uint64_t> LoadProgress::*rows = nullptr) {
+    size_t pos = 0;
+    size_t flushed = 0;
+    uint64_t kept = 0;
+    auto flush = [&](size_t upto) {
+        if (progress) {
+            progress->bytes_parsed.fetch_add(upto - flushed, std::memory_order_relaxed);
+            (progress->*rows).fetch_add(kept, std::memory_order_relaxed);
+        }
+        flushed = upto;
+        kept = 0;
+    };
+    
+    while (pos < data.size()) {
+        const char* nl = static_cast<const char*>(
+            std::memchr(data.data() + pos, '\n', data.size() - pos));
+        size_t end = nl ? static_cast<size_t>(nl - data.data()) : data.size();
+        std::string_view line = data.substr(pos, end - pos);
+        pos = std::min(end + 1, data.size());
+        
+        if (line.empty() || line[0] == '#') continue;
+        if (fn(line)) ++kept;
+        if (pos - flushed >= kProgressStride) flush(pos);
+    }
+    flush(data.size());
+}
+
+// Below this many bytes per worker, thread startup costs more than it saves
+const size_t kMinChunkBytes = 256 * 1024;
+
+// Route tables smaller than this index faster on a single thread
+const size_t kParallelIndexThreshold = 100000;
+
+size_t loaderThreadCount(size_t bytes) {
+    size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(hw, bytes / kMinChunkBytes));
+}
+
+// Splits data into at most n pieces, each ending just after a '\n' (or at
+// the end of the data). Records never span lines (parseLine works on one
+// std::getline line at a time, so a newline inside quotes already ends the
+// record), which makes newline boundaries safe split points.
+std::vector<std::string_view> splitLineChunks(std::string_view data, size_t n) {
+    std::vector<std::string_view> chunks;
+    size_t target = data.size() / std::max<size_t>(1, n);
+    size_t begin = 0;
+    while (begin < data.size()) {
+        size_t end = data.size();
+        if (chunks.size() + 1 < n && begin + target < data.size()) {
+            size_t nl = data.find('\n', begin + target);
+            if (nl != std::string_view::npos) {
+                end = nl + 1;
+            }
+        }
+        chunks.push_back(data.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+// Opens a data file and adds its size to the progress total. The inflated
+// size of a compressed file is unknown up front, so nextBlock() adds each
+// block as it arrives instead.
+bool openInput(DataFile& file, const std::string& filename, LoadProgress* progress) {
+    if (!file.open(filename)) {
+        return false;
+    }
+    if (progress && !file.compressed()) {
+        progress->bytes_total.fetch_add(file.fileSize(), std::memory_order_relaxed);
+    }
+    return true;
+}
+
+bool nextBlock(DataFile& file, std::string_view& block, LoadProgress* progress) {
+    if (!file.next(block)) {
+        return false;
+    }
+    if (progress && file.compressed()) {
+        progress->bytes_total.fetch_add(block.size(), std::memory_order_relaxed);
+    }
+    return true;
+}
+
+// Decodes one row, counting why it was dropped when the schema rejects it
+template <typename Record>
+bool decodeCounted(const std::vector<std::string_view>& fields, Record& record,
+                   LoadReport::TableStats& stats) {
+    if (schema::decodeRecord(fields, record)) {
+        return true;
+    }
+    if (fields.size() < schema::RecordSchema<Record>::kColumns) {
+        ++stats.short_rows;
+    } else {
+        ++stats.missing_code;
+    }
+    return false;
+}
+
+// Finds the row for a code given as text, e.g. from a request body;
+// kNone when the text is too long to be a code
+template <typename Table>
+uint32_t findCode(const Table& table, const std::string& text) {
+    IataCode code;
+    return IataCode::parse(text, code) ? table.find(code) : Table::kNone;
+}
+
+// Packed code of every dense index, used to order count ties by code
+std::vector<uint32_t> codeOrder(const CodeDictionary& codes) {
+    std::vector<uint32_t> order(codes.size());
+    for (size_t i = 0; i < codes.size(); ++i) {
+        order[i] = codes.at(static_cast<uint32_t>(i)).raw();
+    }
+    return order;
+}
+
+} // namespace
+
+Database::Database() {
+}
+
+// Copies every table. All indexes hold row ids rather than pointers, so
+// they stay valid in the copy. Load hooks are not copied.
+Database::Database(const Database& other)
+    : airlines(other.airlines),
+      airports(other.airports),
+      routes(other.routes),
+      routes_by_source(other.routes_by_source),
+      routes_by_dest(other.routes_by_dest),
+      routes_by_airline(other.routes_by_airline),
+      airports_by_airline(other.airports_by_airline),
+      airlines_by_airport(other.airlines_by_airport),
+      airport_traffic(other.airport_traffic),
+      airport_geo(other.airport_geo),
+      reachability(other.reachability),
+      airport_search(other.airport_search) {
+}
+
+Database::~Database() {
+}
+
+void Database::setLoadProgress(LoadProgress* progress) {
+    progress_ = progress;
+}
+
+void Database::setLoadReport(LoadReport* report) {
+    report_ = report;
+}
+
+bool Database::loadAirlines(const std::string& filename) {
+    auto started = std::chrono::steady_clock::now();
+    PhaseClock clock(report_ != nullptr);
+    DataFile file;
+    if (!openInput(file, filename, progress_)) {
+        return false;
+    }
+    clock.lap(LoadReport::kFileIO);
+    
+    CSVParser::FieldBuffer buffer;
+    LoadReport::TableStats stats;
+    auto addRow = [&](std::string_view line) {
+        clock.nextRow();
+        const auto& fields = CSVParser::parseLine(line, buffer);
+        clock.lap(LoadReport::kSplit);
+        
+        // Rows without an IATA code are rejected before any string is copied
+        Airline airline;
+        bool decoded = decodeCounted(fields, airline, stats);
+        clock.lap(LoadReport::kDecode);
+        if (!decoded) return false;
+        if (airline.id <= 0) {
+            ++stats.invalid_id;
+            return false;
+        }
+        IataCode code;
+        if (!IataCode::parse(airline.iata, code)) {
+            ++stats.missing_code;
+            return false;
+        }
+        
+        airlines.stage(code, airline);
+        clock.lap(LoadReport::kInsert);
+        ++stats.accepted;
+        return true;
+    };
+    
+    std::string_view block;
+    while (nextBlock(file, block, progress_)) {
+        clock.lap(LoadReport::kFileIO);
+        clock.beginRows();
+        forEachLine(block, addRow, progress_, &LoadProgress::airlines);
+        clock.endRows();
+    }
+    if (file.failed()) {
+        return false;
+    }
+    airlines.commit();
+    clock.lap(LoadReport::kIndex);
+    
+    if (report_) {
+        report_->source = "csv";
+        report_->airlines = stats;
+        clock.mergeInto(*report_);
+        report_->addStep("airlines", std::chrono::steady_clock::now() - started);
+    }
+    return true;
+}
+
+bool Database::loadAirports(const std::string& filename) {
+    auto started = std::chrono::steady_clock::now();
+    PhaseClock clock(report_ != nullptr);
+    DataFile file;
+    if (!openInput(file, filename, progress_)) {
+        return false;
+    }
+    clock.lap(LoadReport::kFileIO);
+    
+    CSVParser::FieldBuffer buffer;
+    LoadReport::TableStats stats;
+    auto addRow = [&](std::string_view line) {
+        clock.nextRow();
+        const auto& fields = CSVParser::parseLine(line, buffer);
+        clock.lap(LoadReport::kSplit);
+        
+        Airport airport;
+        bool decoded = decodeCounted(fields, airport, stats);
+        clock.lap(LoadReport::kDecode);
+        if (!decoded) return false;
+        if (airport.id <= 0) {
+            ++stats.invalid_id;
+            return false;
+        }
+        IataCode code;
+        if (!IataCode::parse(airport.iata, code)) {
+            ++stats.missing_code;
+            return false;
+        }
+        
+        airports.stage(code, airport);
+        clock.lap(LoadReport::kInsert);
+        ++stats.accepted;
+        return true;
+    };
+    
+    std::string_view block;
+    while (nextBlock(file, block, progress_)) {
+        clock.lap(LoadReport::kFileIO);
+        clock.beginRows();
+        forEachLine(block, addRow, progress_, &LoadProgress::airports);
+        clock.endRows();
+    }
+    if (file.failed()) {
+        return false;
+    }
+    airports.commit();
+    clock.lap(LoadReport::kIndex);
+    
+    if (report_) {
+        report_->airports = stats;
+        clock.mergeInto(*report_);
+        report_->addStep("airports", std::chrono::steady_clock::now() - started);
+    }
+    return true;
+}
+
+bool Database::loadRoutes(const std::string& filename) {
+    auto started = std::chrono::steady_clock::now();
+    PhaseClock clock(report_ != nullptr);
+    DataFile file;
+    if (!openInput(file, filename, progress_)) {
+        return false;
+    }
+    clock.lap(LoadReport::kFileIO);
+    
+    // Each block is split into chunks that are parsed on their own threads
+    // into private buffers, then appended in file order so the result
+    // matches a serial load. A plain file is one block; a compressed one
+    // arrives in blocks while the next is being inflated. Timings and row
+    // counts are kept per chunk and summed at the end.
+    std::vector<std::string_view> chunks;
+    std::vector<std::vector<Route>> parsed;
+    std::vector<PhaseClock> clocks;
+    std::vector<LoadReport::TableStats> stats;
+    
+    auto parseChunk = [&](size_t c) {
+        CSVParser::FieldBuffer buffer;
+        PhaseClock& chunk_clock = clocks[c];
+        chunk_clock.beginRows();
+        forEachLine(chunks[c], [&](std::string_view line) {
+            chunk_clock.nextRow();
+            const auto& fields = CSVParser::parseLine(line, buffer);
+            chunk_clock.lap(LoadReport::kSplit);
+            
+            Route route;
+            bool decoded = decodeCounted(fields, route, stats[c]);
+            chunk_clock.lap(LoadReport::kDecode);
+            if (!decoded) return false;
+            if (route.airline_iata.size() > IataCode::kMaxLength ||
+                route.source_iata.size() > IataCode::kMaxLength ||
+                route.dest_iata.size() > IataCode::kMaxLength) {
+                ++stats[c].missing_code;
+                return false;
+            }
+            
+            parsed[c].push_back(std::move(route));
+            chunk_clock.lap(LoadReport::kInsert);
+            ++stats[c].accepted;
+            return true;
+        }, progress_, &LoadProgress::routes);
+        chunk_clock.endRows();
+    };
+    
+    std::string_view block;
+    while (nextBlock(file, block, progress_)) {
+        clock.lap(LoadReport::kFileIO);
+        chunks = splitLineChunks(block, loaderThreadCount(block.size()));
+        parsed.assign(chunks.size(), std::vector<Route>());
+        if (clocks.size() < chunks.size()) {
+            clocks.resize(chunks.size(), PhaseClock(report_ != nullptr));
+            stats.resize(chunks.size());
+        }
+        
+        std::vector<std::thread> workers;
+        for (size_t c = 1; c < chunks.size(); ++c) {
+            workers.emplace_back(parseChunk, c);
+        }
+        if (!chunks.empty()) {
+            parseChunk(0);
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        clock.restart();
+        
+        size_t total = routes.size();
+        for (const auto& part : parsed) {
+            total += part.size();
+        }
+        routes.reserve(total);
+        for (const auto& part : parsed) {
+            for (const Route& route : part) {
+                routes.append(route);
+            }
+        }
+        clock.lap(LoadReport::kInsert);
+    }
+    if (file.failed()) {
+        return false;
+    }
+    
+    if (report_) {
+        auto parsed_at = std::chrono::steady_clock::now();
+        report_->routes = LoadReport::TableStats();
+        for (size_t c = 0; c < clocks.size(); ++c) {
+            clocks[c].mergeInto(*report_);
+            report_->routes.accepted += stats[c].accepted;
+            report_->routes.short_rows += stats[c].short_rows;
+            report_->routes.missing_code += stats[c].missing_code;
+        }
+        report_->addStep("routes", parsed_at - started);
+    }
+    
+    auto indexing = std::chrono::steady_clock::now();
+    buildIndexes();
+    clock.lap(LoadReport::kIndex);
+    
+    if (report_) {
+        clock.mergeInto(*report_);
+        report_->addStep("route indexes", std::chrono::steady_clock::now() - indexing);
+    }
+    return true;
+}
+
+void Database::buildIndexes() {
+    buildRouteIndexes();
+    locateAirports();
+    rankAirports();
+    buildReachability();
+    indexAirportNames();
+}
+
+void Database::buildRouteIndexes() {
+    // Each index is a counting sort of the route rows by one column. The
+    // forward (by source) and reverse (by dest) adjacency also carry the
+    // airport at the other end. The three are independent, so large tables
+    // build them concurrently.
+    size_t airports = routes.airportCodes().size();
+    size_t airlines = routes.airlineCodes().size();
+    auto buildForward = [&] {
+        routes_by_source.build(routes.sourceColumn(), airports, routes.destColumn());
+    };
+    auto buildReverse = [&] {
+        routes_by_dest.build(routes.destColumn(), airports, routes.sourceColumn());
+    };
+    auto buildByAirline = [&] {
+        routes_by_airline.build(routes.airlineColumn(), airlines);
+    };
+    
+    if (routes.size() < kParallelIndexThreshold) {
+        buildForward();
+        buildReverse();
+        buildByAirline();
+        buildCountMatrices();
+        return;
+    }
+    
+    std::thread reverse_worker(buildReverse);
+    std::thread airline_worker(buildByAirline);
+    buildForward();
+    reverse_worker.join();
+    airline_worker.join();
+    buildCountMatrices();
+}
+
+void Database::buildCountMatrices() {
+    // Route counts per (airline, airport) pair, read off the CSR indexes.
+    // A route counts once at each end, so a route from an airport back to
+    // itself counts twice there, as the per-request reports always did.
+    auto buildByAirline = [&] {
+        airports_by_airline.build(routes.airlineCodes().size(), codeOrder(routes.airportCodes()),
+            [&](uint32_t airline, auto add) {
+                for (uint32_t r : routes_by_airline.rows(airline)) {
+                    add(routes.source(r));
+                    add(routes.dest(r));
+                }
+            });
+    };
+    auto buildByAirport = [&] {
+        airlines_by_airport.build(routes.airportCodes().size(), codeOrder(routes.airlineCodes()),
+            [&](uint32_t airport, auto add) {
+                for (const CsrIndex* index : {&routes_by_source, &routes_by_dest}) {
+                    for (uint32_t r : index->rows(airport)) {
+                        add(routes.airline(r));
+                    }
+                }
+            });
+    };
+    
+    if (routes.size() < kParallelIndexThreshold) {
+        buildByAirline();
+        buildByAirport();
+        return;
+    }
+    
+    std::thread airport_worker(buildByAirport);
+    buildByAirline();
+    airport_worker.join();
+}
+
+Airline Database::getAirlineByIATA(IataCode iata) const {
+    uint32_t row = airlines.find(iata);
+    if (row != EntityTable<Airline>::kNone) {
+        return airlines.get(row);
+    }
+    return Airline(); // Returns airline with id=-1 if not found
+}
+
+Airport Database::getAirportByIATA(IataCode iata) const {
+    uint32_t row = airports.find(iata);
+    if (row != EntityTable<Airport>::kNone) {
+        return airports.get(row);
+    }
+    return Airport(); // Returns airport with id=-1 if not found
+}
+
+void Database::locateAirports() {
+    airport_geo.clear();
+    growAirportGeo();
+    for (size_t r = 0; r < routes.size(); ++r) {
+        routes.setMiles(r, haversineMiles(airport_geo[routes.source(r)], airport_geo[routes.dest(r)]));
+    }
+}
+
+void Database::growAirportGeo() {
+    // Codes with no airport (yet) get a placeholder; their routes are
+    // re-measured when the airport is inserted
+    const CodeDictionary& airport_codes = routes.airportCodes();
+    for (size_t i = airport_geo.size(); i < airport_codes.size(); ++i) {
+        uint32_t row = airports.find(airport_codes.at(static_cast<uint32_t>(i)));
+        airport_geo.push_back(row == EntityTable<Airport>::kNone
+            ? GeoPoint()
+            : geoPoint(airports.row(row).latitude, airports.row(row).longitude));
+    }
+}
+
+void Database::locateAirport(IataCode code) {
+    uint32_t airport = routes.airportCodes().find(code);
+    uint32_t row = airports.find(code);
+    if (airport == CodeDictionary::kNone || row == EntityTable<Airport>::kNone) {
+        return;
+    }
+    growAirportGeo();
+    airport_geo[airport] = geoPoint(airports.row(row).latitude, airports.row(row).longitude);
+    for (const CsrIndex* index : {&routes_by_source, &routes_by_dest}) {
+        for (uint32_t r : index->rows(airport)) {
+            measureRoute(r);
+        }
+    }
+}
+
+void Database::measureRoute(size_t r) {
+    growAirportGeo();
+    routes.setMiles(r, haversineMiles(airport_geo[routes.source(r)], airport_geo[routes.dest(r)]));
+}
+
+TrafficRanking::Entry Database::airportTraffic(IataCode code) const {
+    // Same totals as summing airlinesServing(): only airlines in
+    // airlines.dat count
+    TrafficRanking::Entry entry{code.raw(), 0, 0};
+    uint32_t airport = routes.airportCodes().find(code);
+    if (airport == CodeDictionary::kNone) {
+        return entry;
+    }
+    for (const CountCell& cell : airlines_by_airport.row(airport)) {
+        uint32_t row = airlines.find(routes.airlineCodes().at(cell.col));
+        if (row != EntityTable<Airline>::kNone && airlines.row(row).id > 0) {
+            entry.routes += cell.count;
+            ++entry.airlines;
+        }
+    }
+    return entry;
+}
+
+void Database::rankAirports() {
+    const SortedCodeIndex& sorted = airports.sorted();
+    std::vector<TrafficRanking::Entry> entries;
+    entries.reserve(sorted.size());
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (sorted.code(i) != IataCode()) {
+            entries.push_back(airportTraffic(sorted.code(i)));
+        }
+    }
+    airport_traffic.build(std::move(entries));
+}
+
+// Re-ranks each airport a write touched once. The route counts it reads
+// were patched in place by the write, so this costs the airports' count
+// rows and the ranking entries each one passes.
+void Database::rankAirports(std::vector<IataCode> codes) {
+    std::sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+    for (IataCode code : codes) {
+        rankAirport(code);
+    }
+}
+
+void Database::rankAirport(IataCode code) {
+    if (code == IataCode()) {
+        return;
+    }
+    if (airports.find(code) == EntityTable<Airport>::kNone) {
+        airport_traffic.erase(code);
+    } else {
+        airport_traffic.set(airportTraffic(code));
+    }
+}
+
+std::vector<AirportTrafficView> Database::topAirports(size_t limit) const {
+    const std::vector<TrafficRanking::Entry>& ranked = airport_traffic.entries();
+    std::vector<AirportTrafficView> result;
+    result.reserve(std::min(limit, ranked.size()));
+    for (size_t i = 0; i < ranked.size() && result.size() < limit; ++i) {
+        AirportView airport = findAirport(IataCode::fromRaw(ranked[i].code));
+        result.push_back(AirportTrafficView{airport, static_cast<int>(ranked[i].routes),
+                                            static_cast<int>(ranked[i].airlines)});
+    }
+    return result;
+}
+
+std::vector<AirportRouteCount> Database::getAirportsByAirline(IataCode airline_iata) const {
+    std::vector<AirportRouteCount> result;
+    for (const AirportCountView& entry : airportsServedBy(airline_iata)) {
+        Airport airport = getAirportByIATA(IataCode(entry.airport.iata));
+        result.push_back(AirportRouteCount(airport, entry.route_count));
+    }
+    return result;
+}
+
+std::vector<AirlineRouteCount> Database::getAirlinesByAirport(IataCode airport_iata) const {
+    std::vector<AirlineRouteCount> result;
+    for (const AirlineCountView& entry : airlinesServing(airport_iata)) {
+        Airline airline = getAirlineByIATA(IataCode(entry.airline.iata));
+        result.push_back(AirlineRouteCount(airline, entry.route_count));
+    }
+    return result;
+}
+
+std::vector<AirportCountView> Database::airportsServedBy(IataCode airline_iata) const {
+    std::vector<AirportCountView> result;
+    uint32_t airline = routes.airlineCodes().find(airline_iata);
+    if (airline == CodeDictionary::kNone) {
+        return result;
+    }
+    
+    // The row is already in report order; only airports missing from
+    // airports.dat are skipped
+    CellSpan cells = airports_by_airline.row(airline);
+    result.reserve(cells.size());
+    for (const CountCell& cell : cells) {
+        AirportView airport = findAirport(routes.airportCodes().at(cell.col));
+        if (airport.id > 0) {
+            result.push_back(AirportCountView{airport, static_cast<int>(cell.count)});
+        }
+    }
+    return result;
+}
+
+std::vector<AirlineCountView> Database::airlinesServing(IataCode airport_iata) const {
+    std::vector<AirlineCountView> result;
+    uint32_t airport = routes.airportCodes().find(airport_iata);
+    if (airport == CodeDictionary::kNone) {
+        return result;
+    }
+    
+    CellSpan cells = airlines_by_airport.row(airport);
+    result.reserve(cells.size());
+    for (const CountCell& cell : cells) {
+        AirlineView airline = findAirline(routes.airlineCodes().at(cell.col));
+        if (airline.id > 0) {
+            result.push_back(AirlineCountView{airline, static_cast<int>(cell.count)});
+        }
+    }
+    return result;
+}
+
+AirlineView Database::findAirline(IataCode iata) const {
+    uint32_t row = airlines.find(iata);
+    return row == EntityTable<Airline>::kNone ? AirlineView() : airlines.view(row);
+}
+
+AirportView Database::findAirport(IataCode iata) const {
+    uint32_t row = airports.find(iata);
+    return row == EntityTable<Airport>::kNone ? AirportView() : airports.view(row);
+}
+
+EntityRange<Airline> Database::airlinesSorted() const {
+    return airlines.sortedViews();
+}
+
+EntityRange<Airport> Database::airportsSorted() const {
+    return airports.sortedViews();
+}
+
+void Database::indexAirportNames() {
+    const SortedCodeIndex& sorted = airports.sorted();
+    airport_search.clear();
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        airport_search.stage(sorted.code(i), airports.view(sorted.row(i)).name);
+    }
+    airport_search.merge();
+}
+
+std::vector<AirportView> Database::searchAirports(std::string_view query, size_t limit) const {
+    std::vector<AirportView> result;
+    for (IataCode code : airport_search.search(query, limit)) {
+        result.push_back(findAirport(code));
+    }
+    return result;
+}
+
+std::vector<Airline> Database::getAllAirlinesSorted() const {
+    std::vector<Airline> result;
+    result.reserve(airlines.sorted().size());
+    for (uint32_t row : airlines.sorted().rows()) {
+        result.push_back(airlines.get(row));
+    }
+    return result;
+}
+
+std::vector<Airport> Database::getAllAirportsSorted() const {
+    std::vector<Airport> result;
+    result.reserve(airports.sorted().size());
+    for (uint32_t row : airports.sorted().rows()) {
+        result.push_back(airports.get(row));
+    }
+    return result;
+}
+
+std::string Database::getStudentInfo() const {
+    // TODO: Replace with your actual student ID and name
+    return "Student ID: 20526487, Name: Shreesh Prakash";
+}
+
+double Database::calculateDistance(const Airport& a1, const Airport& a2) const {
+    return haversineMiles(geoPoint(a1.latitude, a1.longitude), geoPoint(a2.latitude, a2.longitude));
+}
+
+std::vector<Database::OneHopRoute> Database::getOneHopRoutes(IataCode source_iata, IataCode dest_iata) const {
+    std::vector<OneHopRoute> result;
+    
+    // Get source and destination airports
+    AirportView source = findAirport(source_iata);
+    AirportView dest = findAirport(dest_iata);
+    
+    if (source.id <= 0 || dest.id <= 0) {
+        return result; // Empty if airports not found
+    }
+    
+    // Dense indices of both endpoints; kNone when no route touches them
+    const CodeDictionary& airport_codes = routes.airportCodes();
+    const CodeDictionary& airline_codes = routes.airlineCodes();
+    uint32_t source_index = airport_codes.find(source_iata);
+    uint32_t dest_index = airport_codes.find(dest_iata);
+    if (source_index == CodeDictionary::kNone || dest_index == CodeDictionary::kNone) {
+        return result;
+    }
+    
+    // Intermediates are out-neighbors(source) ∩ in-neighbors(dest). Both
+    // lists are sorted by airport, with one entry per route, so they
+    // intersect by a merge that gallops whichever side is behind; a hub
+    // pair costs about the shorter list, not an array over every airport.
+    IdSpan out_rows = routes_by_source.rows(source_index);
+    IdSpan out_hops = routes_by_source.neighbors(source_index);
+    IdSpan in_rows = routes_by_dest.rows(dest_index);
+    IdSpan in_hops = routes_by_dest.neighbors(dest_index);
+    const uint32_t* out = out_hops.begin();
+    const uint32_t* in = in_hops.begin();
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    while (out != out_hops.end() && in != in_hops.end()) {
+        if (*out < *in) {
+            out = gallopTo(out, out_hops.end(), *in);
+            continue;
+        }
+        if (*in < *out) {
+            in = gallopTo(in, in_hops.end(), *out);
+            continue;
+        }
+        
+        // Found a connection: source -> intermediate -> dest. The runs of
+        // equal entries are the routes of each leg.
+        uint32_t hop_index = *out;
+        size_t out_first = static_cast<size_t>(out - out_hops.begin());
+        size_t in_first = static_cast<size_t>(in - in_hops.begin());
+        out = std::upper_bound(out, out_hops.end(), hop_index);
+        in = std::upper_bound(in, in_hops.end(), hop_index);
+        size_t out_last = static_cast<size_t>(out - out_hops.begin());
+        size_t in_last = static_cast<size_t>(in - in_hops.begin());
+        
+        AirportView intermediate = findAirport(airport_codes.at(hop_index));
+        if (intermediate.id <= 0) {
+            continue;
+        }
+        
+        // Every airline on the first leg with every airline on the second,
+        // in code order, once each
+        pairs.clear();
+        for (size_t i = out_first; i < out_last; ++i) {
+            for (size_t j = in_first; j < in_last; ++j) {
+                pairs.emplace_back(airline_codes.at(routes.airline(out_rows[i])).raw(),
+                                   airline_codes.at(routes.airline(in_rows[j])).raw());
+            }
+        }
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+        
+        OneHopRoute hop;
+        hop.intermediate = std::string(intermediate.iata);
+        for (const auto& pair : pairs) {
+            hop.airlines.push_back(AirlinePair{IataCode::fromRaw(pair.first).str(),
+                                               IataCode::fromRaw(pair.second).str()});
+        }
+        hop.airline = hop.airlines.front().first_leg;
+        // Total distance: source -> intermediate -> dest, both legs
+        // measured when their routes were stored
+        hop.distance = routes.miles(out_rows[out_first]) + routes.miles(in_rows[in_first]);
+        result.push_back(std::move(hop));
+    }
+    
+    // Sort by distance (shortest first), then by intermediate
+    std::sort(result.begin(), result.end(), 
+        [](const OneHopRoute& a, const OneHopRoute& b) {
+            if (a.distance != b.distance) {
+                return a.distance < b.distance;
+            }
+            return a.intermediate < b.intermediate;
+        });
+    
+    return result;
+}
+
+// Itineraries and reachability only touch airports that airports.dat
+// knows, as one-hop does
+bool Database::routable(uint32_t airport) const {
+    uint32_t row = airports.find(routes.airportCodes().at(airport));
+    return row != EntityTable<Airport>::kNone && airports.row(row).id > 0;
+}
+
+void Database::buildReachability() {
+    reachability.build(routes_by_source, routes.airportCodes().size(),
+        [this](uint32_t airport) { return routable(airport); });
+}
+
+void Database::linkAirports(uint32_t source, uint32_t dest) {
+    // A route may bring a new airport into the route graph
+    reachability.grow(routes.airportCodes().size());
+    if (routable(source) && routable(dest)) {
+        reachability.addLink(source, dest);
+    }
+}
+
+void Database::unlinkAirports(uint32_t source, uint32_t dest) {
+    IdSpan next = routes_by_source.neighbors(source);
+    if (!std::binary_search(next.begin(), next.end(), dest)) {
+        reachability.removeLink(source, routes_by_source,
+            [this](uint32_t airport) { return routable(airport); });
+    }
+}
+
+std::vector<uint32_t> Database::hopCounts(
+        const std::vector<std::pair<IataCode, IataCode>>& pairs) const {
+    const CodeDictionary& airport_codes = routes.airportCodes();
+    std::vector<uint32_t> result;
+    result.reserve(pairs.size());
+    for (const auto& pair : pairs) {
+        uint32_t hops = ReachabilityIndex::kUnreachable;
+        if (pair.first == pair.second) {
+            // An airport no route touches is still where it is
+            uint32_t row = airports.find(pair.first);
+            if (row != EntityTable<Airport>::kNone && airports.row(row).id > 0) {
+                hops = 0;
+            }
+        } else {
+            uint32_t source = airport_codes.find(pair.first);
+            uint32_t dest = airport_codes.find(pair.second);
+            if (source != CodeDictionary::kNone && dest != CodeDictionary::kNone) {
+                hops = reachability.hops(source, dest);
+            }
+        }
+        result.push_back(hops);
+    }
+    return result;
+}
+
+ItineraryResult Database::findItineraries(IataCode source, IataCode dest,
+                                          const ItineraryQuery& query) const {
+    ItinerarySearch search(routes, routes_by_source, airport_geo, reachability,
+                           [this](uint32_t airport) { return routable(airport); });
+    return search.find(source, dest, query);
+}
+
+std::vector<Database::DirectRoute> Database::getDirectRoutes(IataCode source_iata, IataCode dest_iata) const {
+    std::vector<DirectRoute> result;
+    
+    // Get source and destination airports
+    AirportView source = findAirport(source_iata);
+    AirportView dest = findAirport(dest_iata);
+    
+    if (source.id <= 0 || dest.id <= 0) {
+        return result;
+    }
+    
+    // Find all routes from source to destination
+    uint32_t source_index = routes.airportCodes().find(source_iata);
+    uint32_t dest_index = routes.airportCodes().find(dest_iata);
+    if (source_index == CodeDictionary::kNone || dest_index == CodeDictionary::kNone) {
+        return result;
+    }
+    
+    // Look for direct routes (source -> dest)
+    IdSpan out_rows = routes_by_source.rows(source_index);
+    IdSpan out_airports = routes_by_source.neighbors(source_index);
+    for (size_t i = 0; i < out_rows.size(); ++i) {
+        uint32_t r = out_rows[i];
+        if (out_airports[i] == dest_index) {
+            IataCode airline_iata = routes.airlineCodes().at(routes.airline(r));
+            DirectRoute direct;
+            direct.airline_iata = airline_iata.str();
+            direct.stops = routes.stops(r);
+            
+            // Get airline name
+            AirlineView airline = findAirline(airline_iata);
+            direct.airline_name = airline.name.empty() ? direct.airline_iata : std::string(airline.name);
+            
+            direct.distance = routes.miles(r);
+            
+            result.push_back(direct);
+        }
+    }
+    
+    // Sort by distance (shortest first), then by stops
+    std::sort(result.begin(), result.end(), 
+        [](const DirectRoute& a, const DirectRoute& b) {
+            if (a.distance != b.distance) {
+                return a.distance < b.distance;
+            }
+            return a.stops < b.stops;
+        });
+    
+    return result;
+}
+
+// Data update operations
+int Database::getNextAirlineId() const {
+    int max_id = 0;
+    for (uint32_t row = 0; row < airlines.size(); ++row) {
+        max_id = std::max(max_id, airlines.row(row).id);
+    }
+    return max_id + 1;
+}
+
+int Database::getNextAirportId() const {
+    int max_id = 0;
+    for (uint32_t row = 0; row < airports.size(); ++row) {
+        max_id = std::max(max_id, airports.row(row).id);
+    }
+    return max_id + 1;
+}
+
+int Database::getNextRouteId() const {
+    return static_cast<int>(routes.size());
+}
+
+Database::UpdateResult Database::insertAirline(const Airline& airline) {
+    UpdateResult result;
+    
+    IataCode code;
+    if (!IataCode::parse(airline.iata, code)) {
+        result.success = false;
+        result.message = "IATA code " + airline.iata + " is longer than " +
+            std::to_string(IataCode::kMaxLength) + " characters";
+        return result;
+    }
+    
+    if (!airline.iata.empty() && airlines.find(code) != EntityTable<Airline>::kNone) {
+        result.success = false;
+        result.message = "Airline with IATA code " + airline.iata + " already exists";
+        return result;
+    }
+    
+    if (airline.id > 0 && airlines.findId(airline.id) != EntityTable<Airline>::kNone) {
+        result.success = false;
+        result.message = "Airline with ID " + std::to_string(airline.id) + " already exists";
+        return result;
+    }
+    
+    Airline new_airline = airline;
+    if (new_airline.id <= 0) {
+        new_airline.id = getNextAirlineId();
+    }
+    
+    airlines.insert(code, new_airline);
+    
+    // Routes already on file for the code now count towards their airports
+    uint32_t airline_index = routes.airlineCodes().find(code);
+    if (airline_index != CodeDictionary::kNone) {
+        for (const CountCell& cell : airports_by_airline.row(airline_index)) {
+            rankAirport(routes.airportCodes().at(cell.col));
+        }
+    }
+    
+    result.success = true;
+    result.message = "Airline inserted successfully with ID " + std::to_string(new_airline.id);
+    return result;
+}
+
+Database::UpdateResult Database::updateAirline(const std::string& iata, const Airline& updates) {
+    UpdateResult result;
+    
+    uint32_t row = findCode(airlines, iata);
+    if (row == EntityTable<Airline>::kNone) {
+        result.success = false;
+        result.message = "Airline with IATA code " + iata + " not found";
+        return result;
+    }
+    
+    Airline existing = airlines.get(row);
+    
+    if (updates.id > 0 && updates.id != existing.id) {
+        result.success = false;
+        result.message = "Cannot change airline ID";
+        return result;
+    }
+    
+    if (!updates.iata.empty() && updates.iata != iata) {
+        result.success = false;
+        result.message = "Cannot change airline IATA code";
+        return result;
+    }
+    
+    if (!updates.name.empty()) existing.name = updates.name;
+    if (!updates.alias.empty()) existing.alias = updates.alias;
+    if (!updates.icao.empty()) existing.icao = updates.icao;
+    if (!updates.callsign.empty()) existing.callsign = updates.callsign;
+    if (!updates.country.empty()) existing.country = updates.country;
+    if (!updates.active.empty()) existing.active = updates.active;
+    airlines.set(row, existing);
+    
+    result.success = true;
+    result.message = "Airline updated successfully";
+    return result;
+}
+
+Database::UpdateResult Database::deleteAirline(const std::string& iata) {
+    UpdateResult result;
+    
+    uint32_t row = findCode(airlines, iata);
+    if (row == EntityTable<Airline>::kNone) {
+        result.success = false;
+        result.message = "Airline with IATA code " + iata + " not found";
+        return result;
+    }
+    
+    IataCode code = airlines.code(row);
+    
+    uint32_t airline_index = routes.airlineCodes().find(code);
+    std::vector<IataCode> touched;
+    for (const CountCell& cell : airports_by_airline.row(airline_index)) {
+        touched.push_back(routes.airportCodes().at(cell.col));
+    }
+    IdSpan airline_routes = routes_by_airline.rows(airline_index);
+    eraseRoutes(std::vector<uint32_t>(airline_routes.begin(), airline_routes.end()));
+    
+    airlines.erase(row);
+    rankAirports(std::move(touched));
+    buildReachability();
+    
+    result.success = true;
+    result.message = "Airline and all its routes deleted successfully";
+    return result;
+}
+
+Database::UpdateResult Database::insertAirport(const Airport& airport) {
+    UpdateResult result;
+    
+    IataCode code;
+    if (!IataCode::parse(airport.iata, code)) {
+        result.success = false;
+        result.message = "IATA code " + airport.iata + " is longer than " +
+            std::to_string(IataCode::kMaxLength) + " characters";
+        return result;
+    }
+    
+    if (!airport.iata.empty() && airports.find(code) != EntityTable<Airport>::kNone) {
+        result.success = false;
+        result.message = "Airport with IATA code " + airport.iata + " already exists";
+        return result;
+    }
+    
+    if (airport.id > 0 && airports.findId(airport.id) != EntityTable<Airport>::kNone) {
+        result.success = false;
+        result.message = "Airport with ID " + std::to_string(airport.id) + " already exists";
+        return result;
+    }
+    
+    Airport new_airport = airport;
+    if (new_airport.id <= 0) {
+        new_airport.id = getNextAirportId();
+    }
+    
+    airports.insert(code, new_airport);
+    locateAirport(code);
+    rankAirport(code);
+    airport_search.set(code, new_airport.name);
+    // Routes may already name the code; they now lead somewhere
+    uint32_t airport_index = routes.airportCodes().find(code);
+    if (!routes_by_source.rows(airport_index).empty() || !routes_by_dest.rows(airport_index).empty()) {
+        buildReachability();
+    }
+    
+    result.success = true;
+    result.message = "Airport inserted successfully with ID " + std::to_string(new_airport.id);
+    return result;
+}
+
+Database::UpdateResult Database::updateAirport(const std::string& iata, const Airport& updates) {
+    UpdateResult result;
+    
+    uint32_t row = findCode(airports, iata);
+    if (row == EntityTable<Airport>::kNone) {
+        result.success = false;
+        result.message = "Airport with IATA code " + iata + " not found";
+        return result;
+    }
+    
+    Airport existing = airports.get(row);
+    
+    if (updates.id > 0 && updates.id != existing.id) {
+        result.success = false;
+        result.message = "Cannot change airport ID";
+        return result;
+    }
+    
+    if (!updates.iata.empty() && updates.iata != iata) {
+        result.success = false;
+        result.message = "Cannot change airport IATA code";
+        return result;
+    }
+    
+    if (!updates.name.empty()) existing.name = updates.name;
+    if (!updates.city.empty()) existing.city = updates.city;
+    if (!updates.country.empty()) existing.country = updates.country;
+    if (!updates.icao.empty()) existing.icao = updates.icao;
+    if (updates.latitude != 0.0) existing.latitude = updates.latitude;
+    if (updates.longitude != 0.0) existing.longitude = updates.longitude;
+    if (updates.altitude != 0) existing.altitude = updates.altitude;
+    if (updates.timezone != 0.0) existing.timezone = updates.timezone;
+    if (!updates.dst.empty()) existing.dst = updates.dst;
+    if (!updates.tz.empty()) existing.tz = updates.tz;
+    if (!updates.type.empty()) existing.type = updates.type;
+    if (!updates.source.empty()) existing.source = updates.source;
+    airports.set(row, existing);
+    if (updates.latitude != 0.0 || updates.longitude != 0.0) {
+        locateAirport(airports.code(row));
+    }
+    if (!updates.name.empty()) {
+        airport_search.set(airports.code(row), existing.name);
+    }
+    
+    result.success = true;
+    result.message = "Airport updated successfully";
+    return result;
+}
+
+Database::UpdateResult Database::deleteAirport(const std::string& iata) {
+    UpdateResult result;
+    
+    uint32_t row = findCode(airports, iata);
+    if (row == EntityTable<Airport>::kNone) {
+        result.success = false;
+        result.message = "Airport with IATA code " + iata + " not found";
+        return result;
+    }
+    
+    IataCode code = airports.code(row);
+    
+    uint32_t airport_index = routes.airportCodes().find(code);
+    std::vector<IataCode> touched;
+    for (const CsrIndex* index : {&routes_by_source, &routes_by_dest}) {
+        for (uint32_t neighbor : index->neighbors(airport_index)) {
+            touched.push_back(routes.airportCodes().at(neighbor));
+        }
+    }
+    std::sort(touched.begin(), touched.end());
+    touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+    std::vector<uint32_t> airport_routes;
+    for (const CsrIndex* index : {&routes_by_source, &routes_by_dest}) {
+        IdSpan rows = index->rows(airport_index);
+        airport_routes.insert(airport_routes.end(), rows.begin(), rows.end());
+    }
+    eraseRoutes(std::move(airport_routes));
+    
+    airports.erase(row);
+    airport_search.erase(code);
+    touched.push_back(code);
+    rankAirports(std::move(touched));
+    buildReachability();
+    
+    result.success = true;
+    result.message = "Airport and all routes to/from it deleted successfully";
+    return result;
+}
+
+Database::UpdateResult Database::insertRoute(const Route& route) {
+    UpdateResult result;
+    
+    if (findCode(airlines, route.airline_iata) == EntityTable<Airline>::kNone) {
+        result.success = false;
+        result.message = "Airline with IATA code " + route.airline_iata + " does not exist";
+        return result;
+    }
+    
+    if (findCode(airports, route.source_iata) == EntityTable<Airport>::kNone) {
+        result.success = false;
+        result.message = "Source airport with IATA code " + route.source_iata + " does not exist";
+        return result;
+    }
+    
+    if (findCode(airports, route.dest_iata) == EntityTable<Airport>::kNone) {
+        result.success = false;
+        result.message = "Destination airport with IATA code " + route.dest_iata + " does not exist";
+        return result;
+    }
+    
+    // A code no route uses yet has no dense index, so cannot be a duplicate
+    uint32_t airline_index = routes.airlineCodes().find(IataCode(route.airline_iata));
+    uint32_t source_index = routes.airportCodes().find(IataCode(route.source_iata));
+    uint32_t dest_index = routes.airportCodes().find(IataCode(route.dest_iata));
+    if (airline_index != CodeDictionary::kNone && source_index != CodeDictionary::kNone &&
+        dest_index != CodeDictionary::kNone) {
+        IdSpan out_rows = routes_by_source.rows(source_index);
+        IdSpan out_airports = routes_by_source.neighbors(source_index);
+        for (size_t i = 0; i < out_rows.size(); ++i) {
+            if (out_airports[i] == dest_index && routes.airline(out_rows[i]) == airline_index) {
+                result.success = false;
+                result.message = "Route already exists";
+                return result;
+            }
+        }
+    }
+    
+    routes.append(route);
+    measureRoute(routes.size() - 1);
+    indexRoute(static_cast<uint32_t>(routes.size() - 1));
+    rankAirports({IataCode(route.source_iata), IataCode(route.dest_iata)});
+    linkAirports(routes.source(routes.size() - 1), routes.dest(routes.size() - 1));
+    
+    result.success = true;
+    result.message = "Route inserted successfully";
+    return result;
+}
+
+Database::UpdateResult Database::updateRoute(int route_id, const Route& updates) {
+    UpdateResult result;
+    
+    if (route_id < 0 || route_id >= static_cast<int>(routes.size())) {
+        result.success = false;
+        result.message = "Route ID " + std::to_string(route_id) + " not found";
+        return result;
+    }
+    
+    Route existing = routes.get(route_id);
+    IataCode old_source(existing.source_iata);
+    IataCode old_dest(existing.dest_iata);
+    
+    if (!updates.airline_iata.empty() && updates.airline_iata != existing.airline_iata) {
+        uint32_t found = findCode(airlines, updates.airline_iata);
+        if (found == EntityTable<Airline>::kNone) {
+            result.success = false;
+            result.message = "Airline with IATA code " + updates.airline_iata + " does not exist";
+            return result;
+        }
+        existing.airline_iata = updates.airline_iata;
+        existing.airline_id = airlines.row(found).id;
+    }
+    
+    if (!updates.source_iata.empty() && updates.source_iata != existing.source_iata) {
+        uint32_t found = findCode(airports, updates.source_iata);
+        if (found == EntityTable<Airport>::kNone) {
+            result.success = false;
+            result.message = "Source airport with IATA code " + updates.source_iata + " does not exist";
+            return result;
+        }
+        existing.source_iata = updates.source_iata;
+        existing.source_id = airports.row(found).id;
+    }
+    
+    if (!updates.dest_iata.empty() && updates.dest_iata != existing.dest_iata) {
+        uint32_t found = findCode(airports, updates.dest_iata);
+        if (found == EntityTable<Airport>::kNone) {
+            result.success = false;
+            result.message = "Destination airport with IATA code " + updates.dest_iata + " does not exist";
+            return result;
+        }
+        existing.dest_iata = updates.dest_iata;
+        existing.dest_id = airports.row(found).id;
+    }
+    
+    if (!updates.codeshare.empty()) existing.codeshare = updates.codeshare;
+    if (updates.stops >= 0) existing.stops = updates.stops;
+    if (!updates.equipment.empty()) existing.equipment = updates.equipment;
+    
+    RouteTable::Row old_row = routes.row(route_id);
+    unindexRoute(route_id);
+    routes.set(route_id, existing);
+    measureRoute(route_id);
+    indexRoute(route_id);
+    rankAirports({old_source, old_dest, IataCode(existing.source_iata),
+                  IataCode(existing.dest_iata)});
+    unlinkAirports(old_row.source, old_row.dest);
+    linkAirports(routes.source(route_id), routes.dest(route_id));
+    
+    result.success = true;
+    result.message = "Route updated successfully";
+    return result;
+}
+
+Database::UpdateResult Database::deleteRoute(int route_id) {
+    UpdateResult result;
+    
+    if (route_id < 0 || route_id >= static_cast<int>(routes.size())) {
+        result.success = false;
+        result.message = "Route ID " + std::to_string(route_id) + " not found";
+        return result;
+    }
+    
+    RouteTable::Row erased = routes.row(route_id);
+    eraseRoutes({static_cast<uint32_t>(route_id)});
+    rankAirports({routes.airportCodes().at(erased.source), routes.airportCodes().at(erased.dest)});
+    unlinkAirports(erased.source, erased.dest);
+    
+    result.success = true;
+    result.message = "Route deleted successfully";
+    return result;
+}
+
+// Route writes patch the route indexes and count matrices rather than
+// rebuilding them: a CSR insert or erase shifts the entries after it and a
+// count cell moves to its new rank, so a write costs a few linear passes
+// with no sorting. The traffic ranking and reachability are then updated
+// by the caller, for the airports the write touched.
+void Database::indexRoute(uint32_t r) {
+    RouteTable::Row row = routes.row(r);
+    routes_by_source.insert(row.source, r, row.dest);
+    routes_by_dest.insert(row.dest, r, row.source);
+    routes_by_airline.insert(row.airline, r);
+    countRoute(r, true);
+}
+
+// Takes route r out of the indexes before its row changes
+void Database::unindexRoute(uint32_t r) {
+    RouteTable::Row row = routes.row(r);
+    routes_by_source.erase(row.source, r, row.dest);
+    routes_by_dest.erase(row.dest, r, row.source);
+    routes_by_airline.erase(row.airline, r);
+    countRoute(r, false);
+}
+
+// A route counts once at each end, as in buildCountMatrices()
+void Database::countRoute(uint32_t r, bool add) {
+    RouteTable::Row row = routes.row(r);
+    for (uint32_t airport : {row.source, row.dest}) {
+        if (add) {
+            airports_by_airline.increment(row.airline, airport,
+                                          routes.airportCodes().at(airport).raw());
+            airlines_by_airport.increment(airport, row.airline,
+                                          routes.airlineCodes().at(row.airline).raw());
+        } else {
+            airports_by_airline.decrement(row.airline, airport);
+            airlines_by_airport.decrement(airport, row.airline);
+        }
+    }
+}
+
+// Erases the given route rows, in any order, from the table and indexes
+void Database::eraseRoutes(std::vector<uint32_t> rows) {
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    for (uint32_t r : rows) {
+        countRoute(r, false);
+    }
+    routes.eraseIf([&](size_t r) {
+        return std::binary_search(rows.begin(), rows.end(), static_cast<uint32_t>(r));
+    });
+    routes_by_source.eraseRows(rows);
+    routes_by_dest.eraseRows(rows);
+    routes_by_airline.eraseRows(rows);
+}
+
@@ -0,0 +1,69 @@
+#include "../include/entity_table.h"
+
+namespace {
+
+std::string loadText(StrRef ref, const StringArena& arena) {
+    return std::string(arena.view(ref));
+}
+
+} // namespace
+
+void EntityRows<Airline>::store(const Airline& airline, Row& row, StringArena& arena) {
+    row.id = airline.id;
+    row.name = arena.replace(row.name, airline.name);
+    row.alias = arena.replace(row.alias, airline.alias);
+    row.iata = arena.replace(row.iata, airline.iata);
+    row.icao = arena.replace(row.icao, airline.icao);
+    row.callsign = arena.replace(row.callsign, airline.callsign);
+    row.country = arena.replace(row.country, airline.country);
+    row.active = arena.replace(row.active, airline.active);
+}
+
+Airline EntityRows<Airline>::load(const Row& row, const StringArena& arena) {
+    Airline airline;
+    airline.id = row.id;
+    airline.name = loadText(row.name, arena);
+    airline.alias = loadText(row.alias, arena);
+    airline.iata = loadText(row.iata, arena);
+    airline.icao = loadText(row.icao, arena);
+    airline.callsign = loadText(row.callsign, arena);
+    airline.country = loadText(row.country, arena);
+    airline.active = loadText(row.active, arena);
+    return airline;
+}
+
+void EntityRows<Airport>::store(const Airport& airport, Row& row, StringArena& arena) {
+    row.latitude = airport.latitude;
+    row.longitude = airport.longitude;
+    row.timezone = airport.timezone;
+    row.id = airport.id;
+    row.altitude = airport.altitude;
+    row.name = arena.replace(row.name, airport.name);
+    row.city = arena.replace(row.city, airport.city);
+    row.country = arena.replace(row.country, airport.country);
+    row.iata = arena.replace(row.iata, airport.iata);
+    row.icao = arena.replace(row.icao, airport.icao);
+    row.dst = arena.replace(row.dst, airport.dst);
+    row.tz = arena.replace(row.tz, airport.tz);
+    row.type = arena.replace(row.type, airport.type);
+    row.source = arena.replace(row.source, airport.source);
+}
+
+Airport EntityRows<Airport>::load(const Row& row, const StringArena& arena) {
+    Airport airport;
+    airport.latitude = row.latitude;
+    airport.longitude = row.longitude;
+    airport.timezone = row.timezone;
+    airport.id = row.id;
+    airport.altitude = row.altitude;
+    airport.name = loadText(row.name, arena);
+    airport.city = loadText(row.city, arena);
+    airport.country = loadText(row.country, arena);
+    airport.iata = loadText(row.iata, arena);
+    airport.icao = loadText(row.icao, arena);
+    airport.dst = loadText(row.dst, arena);
+    airport.tz = loadText(row.tz, arena);
+    airport.type = loadText(row.type, arena);
+    airport.source = loadText(row.source, arena);
+    return airport;
+}
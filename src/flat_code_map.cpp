@@ -0,0 +1,86 @@
+#include "../include/flat_code_map.h"
+
+void FlatCodeMap::clear() {
+    ctrl_.clear();
+    slots_.clear();
+    group_mask_ = 0;
+    size_ = 0;
+    growth_left_ = 0;
+}
+
+void FlatCodeMap::reserve(size_t n) {
+    // Tables are kept at most 7/8 full
+    size_t groups = 1;
+    while (groups * kGroupSize * 7 / 8 < n) {
+        groups *= 2;
+    }
+    if (groups * kGroupSize > slots_.size()) {
+        rehash(groups);
+    }
+}
+
+void FlatCodeMap::set(IataCode code, uint32_t value) {
+    uint64_t h = hash(code);
+    size_t slot = locate(code, h);
+    if (slot != SIZE_MAX) {
+        slots_[slot].value = value;
+        return;
+    }
+    if (growth_left_ == 0) {
+        // Out of empty slots: grow when mostly live, otherwise rehash in
+        // place to clear the tombstones left by erase()
+        size_t groups = slots_.size() / kGroupSize;
+        if (groups == 0) {
+            groups = 1;
+        } else if (size_ >= slots_.size() * 7 / 16) {
+            groups *= 2;
+        }
+        rehash(groups);
+    }
+    insertNew(h, code.raw(), value);
+}
+
+bool FlatCodeMap::erase(IataCode code) {
+    size_t slot = locate(code, hash(code));
+    if (slot == SIZE_MAX) {
+        return false;
+    }
+    // A tombstone, not kEmpty: later codes may have probed past this slot
+    ctrl_[slot] = kDeleted;
+    --size_;
+    return true;
+}
+
+void FlatCodeMap::insertNew(uint64_t h, uint32_t key, uint32_t value) {
+    size_t group = groupOf(h);
+    for (size_t step = 1;; ++step) {
+        const uint8_t* ctrl = ctrl_.data() + group * kGroupSize;
+        uint32_t free = matchTag(ctrl, kEmpty) | matchTag(ctrl, kDeleted);
+        if (free != 0) {
+            size_t slot = group * kGroupSize + __builtin_ctz(free);
+            if (ctrl_[slot] == kEmpty) {
+                --growth_left_;
+            }
+            ctrl_[slot] = tagOf(h);
+            slots_[slot] = Slot{key, value};
+            ++size_;
+            return;
+        }
+        group = (group + step) & group_mask_;
+    }
+}
+
+void FlatCodeMap::rehash(size_t groups) {
+    std::vector<uint8_t> old_ctrl(groups * kGroupSize, kEmpty);
+    std::vector<Slot> old_slots(groups * kGroupSize, Slot{0, 0});
+    old_ctrl.swap(ctrl_);
+    old_slots.swap(slots_);
+    group_mask_ = groups - 1;
+    size_ = 0;
+    growth_left_ = groups * kGroupSize * 7 / 8;
+    for (size_t i = 0; i < old_ctrl.size(); ++i) {
+        if (old_ctrl[i] < kEmpty) {
+            insertNew(hash(IataCode::fromRaw(old_slots[i].key)), old_slots[i].key, old_slots[i].value);
+        }
+    }
+}
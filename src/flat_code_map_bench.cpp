@@ -0,0 +1,111 @@
+// Lookup microbenchmark: FlatCodeMap against the node-based maps it
+// replaced (IataMap<uint32_t>, and the original std::string-keyed map).
+//
+//   flat_code_map_bench [codes] [lookups]
+//
+// Keys are random 3-letter codes, about the size of the airport table by
+// default. Lookups are 90% hits and run in batches of kBatch; the report
+// gives mean and p99 nanoseconds per lookup over the batches.
+
+#include "../include/flat_code_map.h"
+#include "../include/iata_code.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+const size_t kBatch = 1024;
+// Probe keys are cycled through, so the probe list itself stays in cache
+// and the timings are of the maps
+const size_t kProbeCount = 1 << 14;
+
+struct Result {
+    double mean_ns;
+    double p99_ns;
+    uint64_t checksum;
+};
+
+template <typename Lookup>
+Result run(const std::vector<std::string>& probes, size_t lookups, Lookup lookup) {
+    std::vector<double> batch_ns;
+    uint64_t checksum = 0;
+    for (size_t begin = 0; begin < lookups; begin += kBatch) {
+        size_t end = std::min(lookups, begin + kBatch);
+        auto started = std::chrono::steady_clock::now();
+        for (size_t i = begin; i < end; ++i) {
+            checksum += lookup(probes[i % kProbeCount]);
+        }
+        std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - started;
+        batch_ns.push_back(took.count() / static_cast<double>(end - begin));
+    }
+    double total = 0;
+    for (double ns : batch_ns) {
+        total += ns;
+    }
+    std::sort(batch_ns.begin(), batch_ns.end());
+    size_t p99 = std::min(batch_ns.size() - 1, batch_ns.size() * 99 / 100);
+    return Result{total / static_cast<double>(batch_ns.size()), batch_ns[p99], checksum};
+}
+
+void report(const char* name, const Result& result) {
+    std::printf("%-34s mean %7.2f ns  p99 %7.2f ns  (checksum %llu)\n", name, result.mean_ns,
+                result.p99_ns, static_cast<unsigned long long>(result.checksum));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t code_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 7000;
+    size_t lookup_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000000;
+
+    std::mt19937 rng(42);
+    auto randomCode = [&] {
+        std::string code(3, 'A');
+        for (char& c : code) {
+            c = static_cast<char>('A' + rng() % 26);
+        }
+        return code;
+    };
+
+    std::vector<std::string> codes;
+    std::unordered_map<std::string, uint32_t> by_string;
+    while (codes.size() < code_count && codes.size() < 26 * 26 * 26) {
+        std::string code = randomCode();
+        if (by_string.emplace(code, static_cast<uint32_t>(codes.size())).second) {
+            codes.push_back(code);
+        }
+    }
+
+    IataMap<uint32_t> by_packed;
+    FlatCodeMap flat;
+    for (size_t i = 0; i < codes.size(); ++i) {
+        by_packed[IataCode(codes[i])] = static_cast<uint32_t>(i);
+        flat.set(IataCode(codes[i]), static_cast<uint32_t>(i));
+    }
+
+    std::vector<std::string> probes(kProbeCount);
+    for (std::string& probe : probes) {
+        probe = rng() % 10 == 0 ? randomCode() : codes[rng() % codes.size()];
+    }
+
+    std::printf("%zu codes, %zu lookups\n", codes.size(), lookup_count);
+    report("unordered_map<std::string>", run(probes, lookup_count, [&](const std::string& text) {
+        auto it = by_string.find(text);
+        return it == by_string.end() ? 0u : it->second + 1;
+    }));
+    report("IataMap<uint32_t> (unordered_map)", run(probes, lookup_count, [&](const std::string& text) {
+        auto it = by_packed.find(IataCode(text));
+        return it == by_packed.end() ? 0u : it->second + 1;
+    }));
+    report("FlatCodeMap", run(probes, lookup_count, [&](const std::string& text) {
+        uint32_t row = flat.find(IataCode(text));
+        return row == FlatCodeMap::kNone ? 0u : row + 1;
+    }));
+    return 0;
+}
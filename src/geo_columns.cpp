@@ -0,0 +1,206 @@
+#include "../include/geo_columns.h"
+#include "../include/great_circle.h"
+#include <cmath>
+
+// Chosen by compile flags only (see geo_columns.h): -mavx for AVX
+#if defined(__AVX__)
+#include <immintrin.h>
+#define GEO_COLUMNS_AVX 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define GEO_COLUMNS_SSE2 1
+#endif
+
+namespace {
+
+// The kernels below are written once against these lane operations and
+// instantiated for the widest vector the build has, with plain double for
+// the tail of each batch (and for builds without SIMD)
+struct ScalarLanes {
+    using V = double;
+    static const size_t kWidth = 1;
+    static double set(double c) { return c; }
+    static double load(const double* p) { return *p; }
+    static void store(double* p, double v) { *p = v; }
+    static double add(double a, double b) { return a + b; }
+    static double sub(double a, double b) { return a - b; }
+    static double mul(double a, double b) { return a * b; }
+    static double min(double a, double b) { return a < b ? a : b; }
+    static double sqrt(double a) { return std::sqrt(a); }
+    // a > limit ? then : otherwise, per lane
+    static double select(double a, double limit, double then, double otherwise) {
+        return a > limit ? then : otherwise;
+    }
+};
+
+#ifdef GEO_COLUMNS_AVX
+struct AvxLanes {
+    using V = __m256d;
+    static const size_t kWidth = 4;
+    static __m256d set(double c) { return _mm256_set1_pd(c); }
+    static __m256d load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, __m256d v) { _mm256_storeu_pd(p, v); }
+    static __m256d add(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+    static __m256d sub(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+    static __m256d mul(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+    static __m256d min(__m256d a, __m256d b) { return _mm256_min_pd(a, b); }
+    static __m256d sqrt(__m256d a) { return _mm256_sqrt_pd(a); }
+    static __m256d select(__m256d a, __m256d limit, __m256d then, __m256d otherwise) {
+        return _mm256_blendv_pd(otherwise, then, _mm256_cmp_pd(a, limit, _CMP_GT_OQ));
+    }
+};
+using WideLanes = AvxLanes;
+#elif defined(GEO_COLUMNS_SSE2)
+struct Sse2Lanes {
+    using V = __m128d;
+    static const size_t kWidth = 2;
+    static __m128d set(double c) { return _mm_set1_pd(c); }
+    static __m128d load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, __m128d v) { _mm_storeu_pd(p, v); }
+    static __m128d add(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+    static __m128d sub(__m128d a, __m128d b) { return _mm_sub_pd(a, b); }
+    static __m128d mul(__m128d a, __m128d b) { return _mm_mul_pd(a, b); }
+    static __m128d min(__m128d a, __m128d b) { return _mm_min_pd(a, b); }
+    static __m128d sqrt(__m128d a) { return _mm_sqrt_pd(a); }
+    static __m128d select(__m128d a, __m128d limit, __m128d then, __m128d otherwise) {
+        __m128d mask = _mm_cmpgt_pd(a, limit);
+        return _mm_or_pd(_mm_and_pd(mask, then), _mm_andnot_pd(mask, otherwise));
+    }
+};
+using WideLanes = Sse2Lanes;
+#else
+using WideLanes = ScalarLanes;
+#endif
+
+// Taylor coefficients, in powers of t^2, of sin(t) / t and cos(t). Used
+// for |t| <= pi/2 only, where the first omitted terms are below 1e-17.
+const double kSin[] = {1.0, -1.0 / 6, 1.0 / 120, -1.0 / 5040, 1.0 / 362880,
+                       -1.0 / 39916800, 1.0 / 6227020800.0, -1.0 / 1307674368000.0,
+                       1.0 / 355687428096000.0, -1.0 / 121645100408832000.0,
+                       1.0 / 51090942171709440000.0};
+const double kCos[] = {1.0, -1.0 / 2, 1.0 / 24, -1.0 / 720, 1.0 / 40320,
+                       -1.0 / 3628800, 1.0 / 479001600, -1.0 / 87178291200.0,
+                       1.0 / 20922789888000.0, -1.0 / 6402373705728000.0,
+                       1.0 / 2432902008176640000.0, -1.0 / 1124000727777607680000.0};
+// Maclaurin coefficients, in powers of y^2, of asin(y) / y. Used for
+// 0 <= y <= 1/2, where the truncation error is below 1e-12 radians.
+const double kAsin[] = {1.0, 1.0 / 6, 3.0 / 40, 5.0 / 112, 35.0 / 1152, 63.0 / 2816,
+                        231.0 / 13312, 143.0 / 10240, 6435.0 / 557056, 12155.0 / 1245184,
+                        46189.0 / 5505024, 88179.0 / 12058624, 676039.0 / 104857600,
+                        1300075.0 / 226492416, 5014575.0 / 973078528, 9694845.0 / 2080374784,
+                        100180065.0 / 23622320128.0};
+
+template <typename L, size_t N>
+typename L::V horner(const double (&coefficients)[N], typename L::V z) {
+    using V = typename L::V;
+    V sum = L::set(coefficients[N - 1]);
+    for (size_t i = N - 1; i-- > 0;) {
+        sum = L::add(L::mul(sum, z), L::set(coefficients[i]));
+    }
+    return sum;
+}
+
+// sin and cos of angle (radians, |angle| <= pi), from the half angle so
+// that both polynomials stay within their range
+template <typename L>
+void sinCos(typename L::V angle, typename L::V& sin_out, typename L::V& cos_out) {
+    using V = typename L::V;
+    V t = L::mul(angle, L::set(0.5));
+    V z = L::mul(t, t);
+    V s = L::mul(t, horner<L>(kSin, z));
+    V c = horner<L>(kCos, z);
+    sin_out = L::mul(L::set(2.0), L::mul(s, c));
+    cos_out = L::sub(L::mul(c, c), L::mul(s, s));
+}
+
+template <typename L>
+void unitVector(typename L::V latitude_deg, typename L::V longitude_deg, typename L::V& x,
+                typename L::V& y, typename L::V& z) {
+    using V = typename L::V;
+    V to_rad = L::set(M_PI / 180.0);
+    V sin_lat, cos_lat, sin_lon, cos_lon;
+    sinCos<L>(L::mul(latitude_deg, to_rad), sin_lat, cos_lat);
+    sinCos<L>(L::mul(longitude_deg, to_rad), sin_lon, cos_lon);
+    x = L::mul(cos_lat, cos_lon);
+    y = L::mul(cos_lat, sin_lon);
+    z = sin_lat;
+}
+
+// asin(h) for 0 <= h <= 1. Above 1/2 it uses
+// asin(h) = pi/2 - 2 asin(sqrt((1 - h) / 2)), whose argument is below 1/2.
+template <typename L>
+typename L::V asinUnit(typename L::V h) {
+    using V = typename L::V;
+    V half = L::set(0.5);
+    V folded = L::sqrt(L::mul(L::sub(L::set(1.0), h), half));
+    V y = L::select(h, half, folded, h);
+    V a = L::mul(y, horner<L>(kAsin, L::mul(y, y)));
+    return L::select(h, half, L::sub(L::set(M_PI / 2), L::add(a, a)), a);
+}
+
+// Great-circle miles between unit vectors: the central angle is
+// 2 asin(chord / 2)
+template <typename L>
+typename L::V unitMiles(typename L::V dx, typename L::V dy, typename L::V dz) {
+    using V = typename L::V;
+    V chord2 = L::add(L::add(L::mul(dx, dx), L::mul(dy, dy)), L::mul(dz, dz));
+    V h = L::min(L::mul(L::sqrt(chord2), L::set(0.5)), L::set(1.0));
+    return L::mul(L::set(2.0 * kEarthRadiusMiles), asinUnit<L>(h));
+}
+
+template <typename L>
+void assignLanes(const double* lat, const double* lon, double* x, double* y, double* z, size_t i) {
+    typename L::V vx, vy, vz;
+    unitVector<L>(L::load(lat + i), L::load(lon + i), vx, vy, vz);
+    L::store(x + i, vx);
+    L::store(y + i, vy);
+    L::store(z + i, vz);
+}
+
+template <typename L>
+void milesLanes(const double* x, const double* y, const double* z, double fx, double fy,
+                double fz, double* out, size_t i) {
+    using V = typename L::V;
+    V dx = L::sub(L::load(x + i), L::set(fx));
+    V dy = L::sub(L::load(y + i), L::set(fy));
+    V dz = L::sub(L::load(z + i), L::set(fz));
+    L::store(out + i, unitMiles<L>(dx, dy, dz));
+}
+
+} // namespace
+
+void GeoColumns::assign(const double* latitude_deg, const double* longitude_deg, size_t n) {
+    x_.resize(n);
+    y_.resize(n);
+    z_.resize(n);
+    const size_t width = WideLanes::kWidth;
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        assignLanes<WideLanes>(latitude_deg, longitude_deg, x_.data(), y_.data(), z_.data(), i);
+    }
+    for (; i < n; ++i) {
+        assignLanes<ScalarLanes>(latitude_deg, longitude_deg, x_.data(), y_.data(), z_.data(), i);
+    }
+}
+
+void GeoColumns::milesFrom(double latitude_deg, double longitude_deg, double* out) const {
+    double x, y, z;
+    unitVector<ScalarLanes>(latitude_deg, longitude_deg, x, y, z);
+    milesFromUnit(x, y, z, out);
+}
+
+void GeoColumns::milesFrom(size_t from, double* out) const {
+    milesFromUnit(x_[from], y_[from], z_[from], out);
+}
+
+void GeoColumns::milesFromUnit(double x, double y, double z, double* out) const {
+    const size_t n = size();
+    const size_t width = WideLanes::kWidth;
+    size_t i = 0;
+    for (; i + width <= n; i += width) {
+        milesLanes<WideLanes>(x_.data(), y_.data(), z_.data(), x, y, z, out, i);
+    }
+    for (; i < n; ++i) {
+        milesLanes<ScalarLanes>(x_.data(), y_.data(), z_.data(), x, y, z, out, i);
+    }
+}
@@ -0,0 +1,105 @@
+// Accuracy and throughput of GeoColumns against the scalar haversine.
+//
+//   geo_columns_bench [points] [accuracy_sources]
+//
+// Points are uniform on the sphere, about the size of the airport table
+// by default, plus a few edge cases (a point and its antipode, points a
+// few metres apart). Accuracy compares every pair from the first
+// accuracy_sources points; throughput times an all-pairs sweep both ways.
+
+#include "../include/geo_columns.h"
+#include "../include/great_circle.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point started) {
+    std::chrono::duration<double> took = std::chrono::steady_clock::now() - started;
+    return took.count();
+}
+
+void report(const char* name, double seconds, size_t pairs, double checksum) {
+    std::printf("%-28s %8.3f s  %7.2f ns/pair  (checksum %.6e)\n", name, seconds,
+                seconds * 1e9 / static_cast<double>(pairs), checksum);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t point_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 7000;
+    size_t accuracy_sources = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 500;
+
+    std::vector<double> lat;
+    std::vector<double> lon;
+    auto add = [&](double latitude, double longitude) {
+        lat.push_back(latitude);
+        lon.push_back(longitude);
+    };
+    add(37.6188, -122.375);
+    add(-37.6188, 57.625);   // antipode of the first
+    add(37.61881, -122.37501);
+    add(90.0, 0.0);
+    add(-90.0, 180.0);
+    add(0.0, -180.0);
+    add(0.0, 180.0);
+
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    while (lat.size() < point_count) {
+        add(std::asin(unit(rng)) * 180.0 / M_PI, unit(rng) * 180.0);
+    }
+    size_t n = lat.size();
+
+    std::vector<GeoPoint> points(n);
+    for (size_t i = 0; i < n; ++i) {
+        points[i] = geoPoint(lat[i], lon[i]);
+    }
+    GeoColumns columns;
+    columns.assign(lat.data(), lon.data(), n);
+
+    // Accuracy
+    std::vector<double> miles(n);
+    double max_abs = 0.0;
+    double max_rel = 0.0;
+    for (size_t i = 0; i < std::min(accuracy_sources, n); ++i) {
+        columns.milesFrom(i, miles.data());
+        for (size_t j = 0; j < n; ++j) {
+            double expected = haversineMiles(points[i], points[j]);
+            double error = std::fabs(miles[j] - expected);
+            max_abs = std::max(max_abs, error);
+            if (expected > 1.0) {
+                max_rel = std::max(max_rel, error / expected);
+            }
+        }
+    }
+    std::printf("%zu points; max error %.3e miles, %.3e relative (pairs over 1 mile)\n", n,
+                max_abs, max_rel);
+
+    // Throughput: every ordered pair
+    size_t pairs = n * n;
+    auto started = std::chrono::steady_clock::now();
+    double checksum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            checksum += haversineMiles(points[i], points[j]);
+        }
+    }
+    report("scalar haversineMiles", secondsSince(started), pairs, checksum);
+
+    started = std::chrono::steady_clock::now();
+    checksum = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        columns.milesFrom(i, miles.data());
+        for (double m : miles) {
+            checksum += m;
+        }
+    }
+    report("GeoColumns::milesFrom", secondsSince(started), pairs, checksum);
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "../include/itinerary_search.h"
+#include <algorithm>
+#include <queue>
+
+namespace {
+
+const uint32_t kNoParent = UINT32_MAX;
+
+// A queued partial itinerary, ordered by its bound and then its tie-break
+// (legs for distance order, distance for fewest-legs order)
+struct Open {
+    double bound;
+    double tie;
+    uint32_t node;
+};
+
+struct Later {
+    bool operator()(const Open& a, const Open& b) const {
+        if (a.bound != b.bound) {
+            return a.bound > b.bound;
+        }
+        if (a.tie != b.tie) {
+            return a.tie > b.tie;
+        }
+        return a.node > b.node;
+    }
+};
+
+} // namespace
+
+ItinerarySearch::ItinerarySearch(const RouteTable& routes, const CsrIndex& routes_by_source,
+                                 const std::vector<GeoPoint>& positions,
+                                 const ReachabilityIndex& reachability,
+                                 std::function<bool(uint32_t)> usable)
+    : routes_(routes),
+      routes_by_source_(routes_by_source),
+      positions_(positions),
+      reachability_(reachability),
+      usable_(std::move(usable)) {
+}
+
+ItineraryResult ItinerarySearch::find(IataCode source, IataCode dest,
+                                      const ItineraryQuery& query) const {
+    ItineraryResult result;
+    const CodeDictionary& airport_codes = routes_.airportCodes();
+    uint32_t from = airport_codes.find(source);
+    uint32_t to = airport_codes.find(dest);
+    if (from == CodeDictionary::kNone || to == CodeDictionary::kNone || from == to ||
+        query.limit == 0 || query.max_legs == 0) {
+        return result;
+    }
+
+    std::vector<uint32_t> excluded;
+    for (IataCode code : query.excluded) {
+        uint32_t airport = airport_codes.find(code);
+        if (airport != CodeDictionary::kNone) {
+            excluded.push_back(airport);
+        }
+    }
+    std::sort(excluded.begin(), excluded.end());
+
+    bool fewest_legs = query.order == ItineraryQuery::Order::kFewestLegs;
+    const GeoPoint& target = positions_[to];
+    std::vector<Node> nodes;
+    std::priority_queue<Open, std::vector<Open>, Later> open;
+    std::vector<uint32_t> airlines;
+
+    // Fewest flights from airport to the destination. The index stops
+    // counting at kMaxHops, so beyond that it is at least one more, and
+    // knows nothing about an unusable source, which needs at least one.
+    auto legsToGo = [&](uint32_t airport) {
+        if (airport != to && !usable_(airport)) {
+            return 1u;
+        }
+        uint32_t hops = reachability_.hops(airport, to);
+        return hops == ReachabilityIndex::kUnreachable ? ReachabilityIndex::kMaxHops + 1 : hops;
+    };
+    auto push = [&](const Node& node) {
+        double legs = node.legs + legsToGo(node.airport);
+        if (legs > query.max_legs) {
+            return;
+        }
+        double distance = node.miles + haversineMiles(positions_[node.airport], target);
+        uint32_t id = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(node);
+        open.push(fewest_legs ? Open{legs, distance, id} : Open{distance, legs, id});
+    };
+    push(Node{from, CodeDictionary::kNone, kNoParent, 0, 0.0});
+
+    while (!open.empty() && result.itineraries.size() < query.limit) {
+        uint32_t id = open.top().node;
+        // Nothing has been dropped yet, so a complete itinerary on top is
+        // still exact; only further expansion is cut off
+        if (nodes[id].airport != to && nodes.size() >= kMaxNodes) {
+            result.truncated = true;
+            break;
+        }
+        open.pop();
+        const Node node = nodes[id];
+        if (node.airport == to) {
+            result.itineraries.push_back(build(nodes, id));
+            continue;
+        }
+
+        // One child per neighboring airport: neighbor runs are sorted, so
+        // each run is every route to one airport
+        IdSpan rows = routes_by_source_.rows(node.airport);
+        IdSpan next = routes_by_source_.neighbors(node.airport);
+        for (size_t first = 0, last = 0; first < next.size(); first = last) {
+            uint32_t airport = next[first];
+            for (last = first + 1; last < next.size() && next[last] == airport; ++last) {
+            }
+            if (std::binary_search(excluded.begin(), excluded.end(), airport) ||
+                visits(nodes, id, airport) || !usable_(airport)) {
+                continue;
+            }
+            Node child{airport, node.airline, id, node.legs + 1,
+                       node.miles + routes_.miles(rows[first])};
+            if (!query.same_airline) {
+                push(child);
+                continue;
+            }
+            // Same airline: the first leg picks it, later legs must match
+            airlines.clear();
+            for (size_t i = first; i < last; ++i) {
+                uint32_t airline = routes_.airline(rows[i]);
+                if (node.airline == CodeDictionary::kNone || airline == node.airline) {
+                    airlines.push_back(airline);
+                }
+            }
+            std::sort(airlines.begin(), airlines.end());
+            airlines.erase(std::unique(airlines.begin(), airlines.end()), airlines.end());
+            for (uint32_t airline : airlines) {
+                child.airline = airline;
+                push(child);
+            }
+        }
+    }
+    return result;
+}
+
+bool ItinerarySearch::visits(const std::vector<Node>& nodes, uint32_t node, uint32_t airport) {
+    for (; node != kNoParent; node = nodes[node].parent) {
+        if (nodes[node].airport == airport) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Itinerary ItinerarySearch::build(const std::vector<Node>& nodes, uint32_t node) const {
+    const CodeDictionary& airport_codes = routes_.airportCodes();
+    const CodeDictionary& airline_codes = routes_.airlineCodes();
+    Itinerary itinerary;
+    itinerary.miles = nodes[node].miles;
+    for (; nodes[node].parent != kNoParent; node = nodes[node].parent) {
+        const Node& arrival = nodes[node];
+        const Node& departure = nodes[arrival.parent];
+        ItineraryLeg leg;
+        leg.from = airport_codes.at(departure.airport);
+        leg.to = airport_codes.at(arrival.airport);
+        leg.miles = arrival.miles - departure.miles;
+        if (arrival.airline != CodeDictionary::kNone) {
+            leg.airlines.push_back(airline_codes.at(arrival.airline));
+        } else {
+            IdSpan rows = routes_by_source_.rows(departure.airport);
+            IdSpan next = routes_by_source_.neighbors(departure.airport);
+            auto run = std::equal_range(next.begin(), next.end(), arrival.airport);
+            for (const uint32_t* it = run.first; it != run.second; ++it) {
+                leg.airlines.push_back(airline_codes.at(routes_.airline(rows[it - next.begin()])));
+            }
+            std::sort(leg.airlines.begin(), leg.airlines.end());
+            leg.airlines.erase(std::unique(leg.airlines.begin(), leg.airlines.end()),
+                               leg.airlines.end());
+        }
+        itinerary.legs.push_back(leg);
+    }
+    std::reverse(itinerary.legs.begin(), itinerary.legs.end());
+    return itinerary;
+}
@@ -0,0 +1,96 @@
+#include "../include/load_report.h"
+#include <iomanip>
+#include <sstream>
+#include <sys/resource.h>
+
+namespace {
+
+long peakRssKb() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return usage.ru_maxrss; // Kilobytes on Linux
+}
+
+double toMs(uint64_t ns) {
+    return static_cast<double>(ns) / 1e6;
+}
+
+void tableJSON(std::ostream& oss, const char* name, const LoadReport::TableStats& t) {
+    oss << "\"" << name << "\":{"
+        << "\"accepted\":" << t.accepted << ","
+        << "\"shortRows\":" << t.short_rows << ","
+        << "\"missingCode\":" << t.missing_code << ","
+        << "\"invalidId\":" << t.invalid_id
+        << "}";
+}
+
+} // namespace
+
+const char* LoadReport::phaseName(Phase phase) {
+    switch (phase) {
+        case kFileIO: return "io";
+        case kSplit: return "split";
+        case kDecode: return "decode";
+        case kInsert: return "insert";
+        case kIndex: return "index";
+        default: return "unknown";
+    }
+}
+
+void LoadReport::addStep(const std::string& name, std::chrono::steady_clock::duration wall) {
+    steps.push_back(Step{name,
+        std::chrono::duration<double, std::milli>(wall).count(),
+        peakRssKb()});
+}
+
+std::string LoadReport::toJSON() const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << "{\"source\":\"" << source << "\",\"steps\":[";
+    for (size_t i = 0; i < steps.size(); ++i) {
+        if (i > 0) oss << ",";
+        oss << "{\"name\":\"" << steps[i].name << "\","
+            << "\"wallMs\":" << steps[i].wall_ms << ","
+            << "\"peakRssKb\":" << steps[i].peak_rss_kb << "}";
+    }
+    oss << "],\"phasesMs\":{";
+    for (int p = 0; p < kPhaseCount; ++p) {
+        if (p > 0) oss << ",";
+        oss << "\"" << phaseName(static_cast<Phase>(p)) << "\":" << toMs(phase_ns[p]);
+    }
+    oss << "},\"tables\":{";
+    tableJSON(oss, "airlines", airlines);
+    oss << ",";
+    tableJSON(oss, "airports", airports);
+    oss << ",";
+    tableJSON(oss, "routes", routes);
+    oss << "}}";
+    return oss.str();
+}
+
+void LoadReport::print(std::ostream& out) const {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1);
+    oss << "Load report (" << source << "):\n";
+    for (const auto& step : steps) {
+        oss << "  " << std::left << std::setw(16) << step.name << std::right
+            << std::setw(10) << step.wall_ms << " ms"
+            << std::setw(10) << step.peak_rss_kb / 1024.0 << " MB peak RSS\n";
+    }
+    oss << "  cpu:";
+    for (int p = 0; p < kPhaseCount; ++p) {
+        oss << " " << phaseName(static_cast<Phase>(p)) << " " << toMs(phase_ns[p]) << " ms"
+            << (p + 1 < kPhaseCount ? "," : "\n");
+    }
+    const struct { const char* name; const TableStats* stats; } tables[] = {
+        {"airlines", &airlines}, {"airports", &airports}, {"routes", &routes}};
+    for (const auto& t : tables) {
+        oss << "  " << t.name << ": " << t.stats->accepted << " kept, "
+            << t.stats->short_rows << " short, "
+            << t.stats->missing_code << " missing IATA, "
+            << t.stats->invalid_id << " invalid id\n";
+    }
+    out << oss.str() << std::flush;
+}
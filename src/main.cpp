@@ -1,4 +1,9 @@
 #include "../include/database.h"
+#include "../include/data_file.h"
+#include "../include/data_reloader.h"
+#include "../include/live_database.h"
+#include "../include/load_progress.h"
+#include "../include/load_report.h"
 #include <httplib.h>
 #include <iostream>
 #include <sstream>
@@ -8,11 +13,16 @@
 #include <algorithm>
 #include <map>
 #include <cstdlib>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 
-// Helper function to convert Airline to JSON string
-std::string airlineToJSON(const Airline& airline) {
+// Helper function to convert Airline (or AirlineView) to JSON string
+template <typename AirlineT>
+std::string airlineToJSON(const AirlineT& airline) {
     std::ostringstream oss;
     oss << "{"
         << "\"id\":" << airline.id << ","
@@ -27,8 +37,9 @@ std::string airlineToJSON(const Airline& airline) {
     return oss.str();
 }
 
-// Helper function to convert Airport to JSON string
-std::string airportToJSON(const Airport& airport) {
+// Helper function to convert Airport (or AirportView) to JSON string
+template <typename AirportT>
+std::string airportToJSON(const AirportT& airport) {
     std::ostringstream oss;
     oss << std::fixed << std::setprecision(6);
     oss << "{"
@@ -110,29 +121,223 @@ double getJSONDouble(const std::string& json, const std::string& key, double def
     }
 }
 
-int main() {
-    Database db;
+// Reads "key":[["AAA","BBB"],...] as code pairs. Returns false when the key
+// is missing, the array is malformed or a code is not a valid IATA code.
+bool getJSONCodePairs(const std::string& json, const std::string& key,
+                      std::vector<std::pair<IataCode, IataCode>>& pairs) {
+    size_t pos = json.find("\"" + key + "\":");
+    if (pos == std::string::npos) return false;
+    pos = json.find('[', pos);
+    if (pos == std::string::npos) return false;
+    
+    std::vector<IataCode> codes;
+    int depth = 0;
+    for (; pos < json.length(); ++pos) {
+        if (json[pos] == '[') {
+            ++depth;
+        } else if (json[pos] == ']') {
+            if (--depth == 0) break;
+        } else if (json[pos] == '"') {
+            size_t end = json.find('"', pos + 1);
+            if (end == std::string::npos) return false;
+            IataCode code;
+            if (!IataCode::parse(std::string_view(json).substr(pos + 1, end - pos - 1), code) ||
+                code == IataCode()) {
+                return false;
+            }
+            codes.push_back(code);
+            pos = end;
+        }
+    }
+    if (depth != 0 || codes.size() % 2 != 0) return false;
+    
+    for (size_t i = 0; i < codes.size(); i += 2) {
+        pairs.emplace_back(codes[i], codes[i + 1]);
+    }
+    return true;
+}
+
+// Loads the data files into db, preferring a binary snapshot that matches
+// them. With write_snapshot set the CSV files are always parsed and failing
+// to write the snapshot is an error. Returns false on any fatal error.
+bool loadData(Database& db, const std::string& snapshot_path, bool write_snapshot) {
+    // Each file may also be shipped as a .zst or .gz copy
+    const std::vector<std::string> data_files = {
+        resolveDataFile("airlines.dat"),
+        resolveDataFile("airports.dat"),
+        resolveDataFile("routes.dat")
+    };
+    
+    if (!write_snapshot && db.loadSnapshot(snapshot_path, data_files)) {
+        std::cout << "Loaded snapshot " << snapshot_path << std::endl;
+        return true;
+    }
     
-    // Load data files
     std::cout << "Loading airlines..." << std::endl;
-    if (!db.loadAirlines("airlines.dat")) {
-        std::cerr << "Error: Could not load airlines.dat" << std::endl;
-        return 1;
+    if (!db.loadAirlines(data_files[0])) {
+        std::cerr << "Error: Could not load " << data_files[0] << std::endl;
+        return false;
     }
     
     std::cout << "Loading airports..." << std::endl;
-    if (!db.loadAirports("airports.dat")) {
-        std::cerr << "Error: Could not load airports.dat" << std::endl;
-        return 1;
+    if (!db.loadAirports(data_files[1])) {
+        std::cerr << "Error: Could not load " << data_files[1] << std::endl;
+        return false;
     }
     
     std::cout << "Loading routes..." << std::endl;
-    if (!db.loadRoutes("routes.dat")) {
-        std::cerr << "Error: Could not load routes.dat" << std::endl;
-        return 1;
+    if (!db.loadRoutes(data_files[2])) {
+        std::cerr << "Error: Could not load " << data_files[2] << std::endl;
+        return false;
     }
     
-    std::cout << "Data loaded successfully!" << std::endl;
+    // Next start can skip CSV parsing entirely
+    if (!db.saveSnapshot(snapshot_path, data_files)) {
+        std::cerr << "Warning: Could not write snapshot " << snapshot_path << std::endl;
+        return !write_snapshot;
+    }
+    return true;
+}
+
+// Packs a code path parameter such as :iata. Text too long to be a code
+// yields false, which handlers answer the same way as an unknown code.
+bool codeParam(const httplib::Request& req, const char* name, IataCode& code) {
+    return IataCode::parse(req.path_params.at(name), code);
+}
+
+// Wraps a read-only handler so it runs against the currently published
+// Database, or answers 503 while the data is still loading. The shared_ptr
+// keeps that instance alive until the handler returns, even if a reload
+// publishes a newer one meanwhile.
+template <typename Handler>
+httplib::Server::Handler withDatabase(const LiveDatabase& live, Handler handler) {
+    return [&live, handler](const httplib::Request& req, httplib::Response& res) {
+        std::shared_ptr<const Database> db = live.acquire();
+        if (!db) {
+            res.status = 503;
+            res.set_content("{\"error\":\"Database is loading\"}", "application/json");
+            return;
+        }
+        handler(*db, req, res);
+    };
+}
+
+// Wraps a handler that modifies data and returns its Database::UpdateResult.
+// It runs on a private copy of the live Database, which replaces it only if
+// the update succeeded, so concurrent readers never observe a partially
+// applied update and rejected writes publish nothing.
+template <typename Handler>
+httplib::Server::Handler withWritableDatabase(LiveDatabase& live, Handler handler) {
+    return [&live, handler](const httplib::Request& req, httplib::Response& res) {
+        Database::UpdateResult result;
+        bool loaded = live.update([&](Database& db) {
+            result = handler(db, req);
+            return result.success;
+        });
+        if (!loaded) {
+            res.status = 503;
+            res.set_content("{\"error\":\"Database is loading\"}", "application/json");
+            return;
+        }
+        std::ostringstream oss;
+        oss << "{\"success\":" << (result.success ? "true" : "false") 
+            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
+        res.set_content(oss.str(), "application/json");
+    };
+}
+
+int main(int argc, char* argv[]) {
+    const char* snapshot_env = std::getenv("AIRTRAVEL_SNAPSHOT");
+    std::string snapshot_path = snapshot_env ? snapshot_env : "airtravel.snapshot";
+    
+    // --write-snapshot: parse the .dat files, write the snapshot and exit
+    // (used at image build time so containers start from the snapshot)
+    if (argc > 1 && std::string(argv[1]) == "--write-snapshot") {
+        Database db;
+        LoadReport report;
+        db.setLoadReport(&report);
+        if (!loadData(db, snapshot_path, true)) {
+            return 1;
+        }
+        report.print(std::cout);
+        std::cout << "Wrote snapshot " << snapshot_path << std::endl;
+        return 0;
+    }
+    
+    // AIRTRAVEL_BACKGROUND_LOAD=1 opens the port before loading: /healthz and
+    // /readyz answer right away and data endpoints return 503 until ready
+    const char* background_env = std::getenv("AIRTRAVEL_BACKGROUND_LOAD");
+    bool background_load = background_env && std::string(background_env) == "1";
+    
+    LiveDatabase live;
+    LoadProgress progress;
+    // Report of the most recent load, failed or not; swapped atomically
+    std::shared_ptr<const LoadReport> last_report;
+    // Loads share progress, last_report and the snapshot file, so they run
+    // one at a time: the initial load holds this until it has published,
+    // and reloads take it through load()
+    std::mutex load_mutex;
+    auto load_locked = [&progress, &last_report, &snapshot_path]() -> std::shared_ptr<Database> {
+        progress.reset();
+        auto report = std::make_shared<LoadReport>();
+        auto db = std::make_shared<Database>();
+        db->setLoadProgress(&progress);
+        db->setLoadReport(report.get());
+        bool loaded = loadData(*db, snapshot_path, false);
+        db->setLoadProgress(nullptr);
+        db->setLoadReport(nullptr);
+        report->print(std::cout);
+        std::atomic_store(&last_report, std::shared_ptr<const LoadReport>(report));
+        if (!loaded) {
+            return nullptr;
+        }
+        std::cout << "Data loaded successfully!" << std::endl;
+        return db;
+    };
+    auto load = [&load_mutex, &load_locked]() {
+        std::lock_guard<std::mutex> lock(load_mutex);
+        return load_locked();
+    };
+    
+    // A background initial load holds load_mutex from before the reloader
+    // exists until it has published
+    std::thread loader;
+    if (background_load) {
+        std::promise<void> locked;
+        loader = std::thread([&load_mutex, &load_locked, &live, &locked]() {
+            std::lock_guard<std::mutex> lock(load_mutex);
+            locked.set_value();
+            std::shared_ptr<Database> db = load_locked();
+            if (!db) {
+                // Nothing to serve; exit so the orchestrator restarts the pod
+                std::_Exit(1);
+            }
+            live.publish(db);
+        });
+        locked.get_future().wait();
+    } else {
+        std::shared_ptr<Database> db = load();
+        if (!db) {
+            return 1;
+        }
+        live.publish(db);
+    }
+    
+    // Hot reload: POST /admin/reload, or AIRTRAVEL_WATCH_DATA=1 to reload
+    // whenever a .dat file in the working directory is rewritten
+    DataReloader reloader(live, load);
+    const char* watch_env = std::getenv("AIRTRAVEL_WATCH_DATA");
+    if (watch_env && std::string(watch_env) == "1") {
+        std::vector<std::string> watched;
+        for (const char* name : {"airlines.dat", "airports.dat", "routes.dat"}) {
+            for (const char* suffix : {"", ".gz", ".zst"}) {
+                watched.push_back(std::string(name) + suffix);
+            }
+        }
+        if (!reloader.watch(".", watched)) {
+            std::cerr << "Warning: Could not watch data files for changes" << std::endl;
+        }
+    }
     
     // Create HTTP server
     httplib::Server svr;
@@ -1436,7 +1641,7 @@ int main() {
                         
                         html += '<div class="result-item" style="border-left-color: ' + color + ';"><h4>Route ' + (i + 1) + '</h4>' +
                                 '<p><strong>Path:</strong> ' + source + ' → ' + route.intermediate + ' → ' + dest + '</p>' +
-                                '<p><strong>Airline:</strong> ' + route.airline + '</p>' +
+                                '<p><strong>Airlines:</strong> ' + route.airlines.map(function(a) { return a.first + ' / ' + a.second; }).join(', ') + '</p>' +
                                 '<p><strong>Distance:</strong> ' + route.distance.toFixed(2) + ' miles</p></div>';
                     }
                 }
@@ -2494,9 +2699,12 @@ int main() {
     });
     
     // Get airline by IATA code
-    svr.Get("/airline/:iata", [&db](const httplib::Request& req, httplib::Response& res) {
-        std::string iata = req.path_params.at("iata");
-        Airline airline = db.getAirlineByIATA(iata);
+    svr.Get("/airline/:iata", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
+        IataCode iata;
+        AirlineView airline;
+        if (codeParam(req, "iata", iata)) {
+            airline = db.findAirline(iata);
+        }
         
         if (airline.id > 0) {
             res.set_content(airlineToJSON(airline), "application/json");
@@ -2504,12 +2712,15 @@ int main() {
             res.status = 404;
             res.set_content("{\"error\":\"Airline not found\"}", "application/json");
         }
-    });
+    }));
     
     // Get airport by IATA code
-    svr.Get("/airport/:iata", [&db](const httplib::Request& req, httplib::Response& res) {
-        std::string iata = req.path_params.at("iata");
-        Airport airport = db.getAirportByIATA(iata);
+    svr.Get("/airport/:iata", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
+        IataCode iata;
+        AirportView airport;
+        if (codeParam(req, "iata", iata)) {
+            airport = db.findAirport(iata);
+        }
         
         if (airport.id > 0) {
             res.set_content(airportToJSON(airport), "application/json");
@@ -2517,12 +2728,15 @@ int main() {
             res.status = 404;
             res.set_content("{\"error\":\"Airport not found\"}", "application/json");
         }
-    });
+    }));
     
     // Get airports served by airline (ordered by route count)
-    svr.Get("/airline/:iata/routes", [&db](const httplib::Request& req, httplib::Response& res) {
-        std::string iata = req.path_params.at("iata");
-        auto airports = db.getAirportsByAirline(iata);
+    svr.Get("/airline/:iata/routes", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
+        IataCode iata;
+        std::vector<AirportCountView> airports;
+        if (codeParam(req, "iata", iata)) {
+            airports = db.airportsServedBy(iata);
+        }
         
         std::ostringstream oss;
         oss << "[";
@@ -2536,12 +2750,15 @@ int main() {
         oss << "]";
         
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Get airlines serving airport (ordered by route count)
-    svr.Get("/airport/:iata/airlines", [&db](const httplib::Request& req, httplib::Response& res) {
-        std::string iata = req.path_params.at("iata");
-        auto airlines = db.getAirlinesByAirport(iata);
+    svr.Get("/airport/:iata/airlines", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
+        IataCode iata;
+        std::vector<AirlineCountView> airlines;
+        if (codeParam(req, "iata", iata)) {
+            airlines = db.airlinesServing(iata);
+        }
         
         std::ostringstream oss;
         oss << "[";
@@ -2555,11 +2772,11 @@ int main() {
         oss << "]";
         
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Get all airlines (sorted by IATA)
-    svr.Get("/airlines", [&db](const httplib::Request&, httplib::Response& res) {
-        auto airlines = db.getAllAirlinesSorted();
+    svr.Get("/airlines", withDatabase(live, [](const Database& db, const httplib::Request&, httplib::Response& res) {
+        auto airlines = db.airlinesSorted();
         
         std::ostringstream oss;
         oss << "[";
@@ -2570,10 +2787,10 @@ int main() {
         oss << "]";
         
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Get airlines with pagination
-    svr.Get("/airlines/list", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Get("/airlines/list", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
         int page = 1;
         int pageSize = 100;
         
@@ -2595,24 +2812,23 @@ int main() {
             } catch (...) {}
         }
         
-        auto allAirlines = db.getAllAirlinesSorted();
+        auto allAirlines = db.airlinesSorted();
         int total = static_cast<int>(allAirlines.size());
-        int start = (page - 1) * pageSize;
-        int end = std::min(start + pageSize, total);
+        auto pageRows = allAirlines.slice(static_cast<size_t>(page - 1) * pageSize, pageSize);
         
         std::ostringstream oss;
         oss << "{\"total\":" << total << ",\"page\":" << page << ",\"pageSize\":" << pageSize << ",\"airlines\":[";
-        for (int i = start; i < end; ++i) {
-            if (i > start) oss << ",";
-            oss << airlineToJSON(allAirlines[i]);
+        for (size_t i = 0; i < pageRows.size(); ++i) {
+            if (i > 0) oss << ",";
+            oss << airlineToJSON(pageRows[i]);
         }
         oss << "]}";
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Get all airports (sorted by IATA)
-    svr.Get("/airports", [&db](const httplib::Request&, httplib::Response& res) {
-        auto airports = db.getAllAirportsSorted();
+    svr.Get("/airports", withDatabase(live, [](const Database& db, const httplib::Request&, httplib::Response& res) {
+        auto airports = db.airportsSorted();
         
         std::ostringstream oss;
         oss << "[";
@@ -2623,71 +2839,19 @@ int main() {
         oss << "]";
         
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Search airports endpoint (for autocomplete - returns limited results)
-    svr.Get("/airports/search", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Get("/airports/search", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
         std::string query = req.get_param_value("q");
         if (query.empty()) {
             res.set_content("[]", "application/json");
             return;
         }
         
-        // Convert to lowercase for case-insensitive search
-        std::string queryLower = query;
-        std::transform(queryLower.begin(), queryLower.end(), queryLower.begin(), ::tolower);
-        
-        auto allAirports = db.getAllAirportsSorted();
-        std::vector<Airport> results;
-        
-        // Collect all matching airports first
-        for (const auto& airport : allAirports) {
-            std::string iata = airport.iata;
-            std::string name = airport.name;
-            std::string city = airport.city;
-            std::string country = airport.country;
-            
-            std::transform(iata.begin(), iata.end(), iata.begin(), ::tolower);
-            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-            std::transform(city.begin(), city.end(), city.begin(), ::tolower);
-            std::transform(country.begin(), country.end(), country.begin(), ::tolower);
-            
-            // Check if query matches IATA code or name only (same as airline search)
-            if (iata.find(queryLower) != std::string::npos ||
-                name.find(queryLower) != std::string::npos) {
-                results.push_back(airport);
-            }
-        }
-        
-        // Sort results: exact IATA match first, then IATA starts with, then name starts with (same as airline search)
-        std::sort(results.begin(), results.end(), [&queryLower](const Airport& a, const Airport& b) {
-            std::string aIata = a.iata;
-            std::string bIata = b.iata;
-            std::string aName = a.name;
-            std::string bName = b.name;
-            
-            std::transform(aIata.begin(), aIata.end(), aIata.begin(), ::tolower);
-            std::transform(bIata.begin(), bIata.end(), bIata.begin(), ::tolower);
-            std::transform(aName.begin(), aName.end(), aName.begin(), ::tolower);
-            std::transform(bName.begin(), bName.end(), bName.begin(), ::tolower);
-            
-            // Exact IATA match first
-            if (aIata == queryLower && bIata != queryLower) return true;
-            if (bIata == queryLower && aIata != queryLower) return false;
-            // IATA starts with query
-            if (aIata.find(queryLower) == 0 && bIata.find(queryLower) != 0) return true;
-            if (bIata.find(queryLower) == 0 && aIata.find(queryLower) != 0) return false;
-            // Name starts with query
-            if (aName.find(queryLower) == 0 && bName.find(queryLower) != 0) return true;
-            if (bName.find(queryLower) == 0 && aName.find(queryLower) != 0) return false;
-            // Alphabetical by IATA
-            return aIata < bIata;
-        });
-        
-        // Limit to top 20 after sorting
-        if (results.size() > 20) {
-            results.resize(20);
-        }
+        // Ranked matches from the trigram index: exact IATA, IATA prefix,
+        // name prefix, then alphabetical by IATA
+        auto results = db.searchAirports(query, 20);
         
         std::ostringstream oss;
         oss << "[";
@@ -2697,10 +2861,10 @@ int main() {
         }
         oss << "]";
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Get top airports by traffic (server-side calculation)
-    svr.Get("/airports/top", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Get("/airports/top", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
         int limit = 20;
         std::string limitStr = req.get_param_value("limit");
         if (!limitStr.empty()) {
@@ -2710,54 +2874,30 @@ int main() {
             } catch (...) {}
         }
         
-        auto allAirports = db.getAllAirportsSorted();
-        std::vector<std::pair<Airport, int>> airportStats; // airport, route count
-        
-        // Calculate route counts for each airport
-        for (const auto& airport : allAirports) {
-            if (airport.iata.empty()) continue;
-            
-            auto airlines = db.getAirlinesByAirport(airport.iata);
-            int totalRoutes = 0;
-            for (const auto& ar : airlines) {
-                totalRoutes += ar.route_count;
-            }
-            
-            airportStats.push_back({airport, totalRoutes});
-        }
-        
-        // Sort by route count descending
-        std::sort(airportStats.begin(), airportStats.end(), 
-                  [](const std::pair<Airport, int>& a, const std::pair<Airport, int>& b) {
-                      return a.second > b.second;
-                  });
-        
-        // Limit results
-        if (airportStats.size() > static_cast<size_t>(limit)) {
-            airportStats.resize(limit);
-        }
+        // The ranking is maintained on every write, so this reads its head
+        auto airportStats = db.topAirports(limit < 0 ? SIZE_MAX : static_cast<size_t>(limit));
         
         std::ostringstream oss;
         oss << "[";
         for (size_t i = 0; i < airportStats.size(); ++i) {
             if (i > 0) oss << ",";
             oss << "{"
-                << "\"airport\":" << airportToJSON(airportStats[i].first) << ","
-                << "\"routeCount\":" << airportStats[i].second << ","
-                << "\"airlineCount\":" << db.getAirlinesByAirport(airportStats[i].first.iata).size()
+                << "\"airport\":" << airportToJSON(airportStats[i].airport) << ","
+                << "\"routeCount\":" << airportStats[i].route_count << ","
+                << "\"airlineCount\":" << airportStats[i].airline_count
                 << "}";
         }
         oss << "]";
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Get geographic statistics (server-side calculation)
-    svr.Get("/airports/geographic", [&db](const httplib::Request&, httplib::Response& res) {
-        auto allAirports = db.getAllAirportsSorted();
+    svr.Get("/airports/geographic", withDatabase(live, [](const Database& db, const httplib::Request&, httplib::Response& res) {
+        auto allAirports = db.airportsSorted();
         std::map<std::string, int> countryCount;
         
         for (const auto& airport : allAirports) {
-            std::string country = airport.country.empty() ? "Unknown" : airport.country;
+            std::string country = airport.country.empty() ? std::string("Unknown") : std::string(airport.country);
             countryCount[country]++;
         }
         
@@ -2784,10 +2924,10 @@ int main() {
         }
         oss << "]}";
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Get airports with pagination
-    svr.Get("/airports/list", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Get("/airports/list", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
         int page = 1;
         int pageSize = 100;
         
@@ -2809,26 +2949,25 @@ int main() {
             } catch (...) {}
         }
         
-        auto allAirports = db.getAllAirportsSorted();
+        auto allAirports = db.airportsSorted();
         int total = static_cast<int>(allAirports.size());
-        int start = (page - 1) * pageSize;
-        int end = std::min(start + pageSize, total);
+        auto pageRows = allAirports.slice(static_cast<size_t>(page - 1) * pageSize, pageSize);
         
         std::ostringstream oss;
         oss << "{\"total\":" << total << ",\"page\":" << page << ",\"pageSize\":" << pageSize << ",\"airports\":[";
-        for (int i = start; i < end; ++i) {
-            if (i > start) oss << ",";
-            oss << airportToJSON(allAirports[i]);
+        for (size_t i = 0; i < pageRows.size(); ++i) {
+            if (i > 0) oss << ",";
+            oss << airportToJSON(pageRows[i]);
         }
         oss << "]}";
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Get student info
-    svr.Get("/student", [&db](const httplib::Request&, httplib::Response& res) {
+    svr.Get("/student", withDatabase(live, [](const Database& db, const httplib::Request&, httplib::Response& res) {
         std::string info = db.getStudentInfo();
         res.set_content("{\"info\":\"" + info + "\"}", "application/json");
-    });
+    }));
     
     // Get source code (extra credit)
     svr.Get("/code", [](const httplib::Request&, httplib::Response& res) {
@@ -2864,12 +3003,13 @@ int main() {
     });
     
     // Direct routes finder
-    svr.Get("/direct/:source/:dest", [&db](const httplib::Request& req, httplib::Response& res) {
-        std::string source = req.path_params.at("source");
-        std::string dest = req.path_params.at("dest");
-        
-        Airport source_airport = db.getAirportByIATA(source);
-        Airport dest_airport = db.getAirportByIATA(dest);
+    svr.Get("/direct/:source/:dest", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
+        IataCode source, dest;
+        AirportView source_airport, dest_airport;
+        if (codeParam(req, "source", source) && codeParam(req, "dest", dest)) {
+            source_airport = db.findAirport(source);
+            dest_airport = db.findAirport(dest);
+        }
         
         if (source_airport.id <= 0 || dest_airport.id <= 0) {
             res.status = 404;
@@ -2895,15 +3035,16 @@ int main() {
         }
         oss << "]}";
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // Direct routes finder with airport details
-    svr.Get("/direct/:source/:dest", [&db](const httplib::Request& req, httplib::Response& res) {
-        std::string source = req.path_params.at("source");
-        std::string dest = req.path_params.at("dest");
-        
-        Airport source_airport = db.getAirportByIATA(source);
-        Airport dest_airport = db.getAirportByIATA(dest);
+    svr.Get("/direct/:source/:dest", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
+        IataCode source, dest;
+        AirportView source_airport, dest_airport;
+        if (codeParam(req, "source", source) && codeParam(req, "dest", dest)) {
+            source_airport = db.findAirport(source);
+            dest_airport = db.findAirport(dest);
+        }
         
         if (source_airport.id <= 0 || dest_airport.id <= 0) {
             res.status = 404;
@@ -2929,16 +3070,17 @@ int main() {
         }
         oss << "]}";
         res.set_content(oss.str(), "application/json");
-    });
+    }));
     
     // One-hop route finder (extra credit)
-    svr.Get("/onehop/:source/:dest", [&db](const httplib::Request& req, httplib::Response& res) {
-        std::string source = req.path_params.at("source");
-        std::string dest = req.path_params.at("dest");
-        
-        // Get source and destination airports
-        Airport source_airport = db.getAirportByIATA(source);
-        Airport dest_airport = db.getAirportByIATA(dest);
+    svr.Get("/onehop/:source/:dest", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
+        IataCode source, dest;
+        AirportView source_airport, dest_airport;
+        if (codeParam(req, "source", source) && codeParam(req, "dest", dest)) {
+            // Get source and destination airports
+            source_airport = db.findAirport(source);
+            dest_airport = db.findAirport(dest);
+        }
         
         if (source_airport.id <= 0 || dest_airport.id <= 0) {
             res.status = 404;
@@ -2959,16 +3101,144 @@ int main() {
             oss << "{"
                 << "\"intermediate\":\"" << routes[i].intermediate << "\","
                 << "\"airline\":\"" << routes[i].airline << "\","
+                << "\"airlines\":[";
+            for (size_t j = 0; j < routes[i].airlines.size(); ++j) {
+                if (j > 0) oss << ",";
+                oss << "{"
+                    << "\"first\":\"" << routes[i].airlines[j].first_leg << "\","
+                    << "\"second\":\"" << routes[i].airlines[j].second_leg << "\""
+                    << "}";
+            }
+            oss << "],"
                 << "\"distance\":" << std::fixed << std::setprecision(2) << routes[i].distance
                 << "}";
         }
         oss << "]}";
         res.set_content(oss.str(), "application/json");
-    });
+    }));
+    
+    // Itineraries with up to max_legs legs, best first
+    svr.Get("/itineraries/:source/:dest", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
+        IataCode source, dest;
+        AirportView source_airport, dest_airport;
+        if (codeParam(req, "source", source) && codeParam(req, "dest", dest)) {
+            source_airport = db.findAirport(source);
+            dest_airport = db.findAirport(dest);
+        }
+        
+        if (source_airport.id <= 0 || dest_airport.id <= 0) {
+            res.status = 404;
+            res.set_content("{\"error\":\"Airport not found\",\"itineraries\":[],\"source\":null,\"dest\":null}", "application/json");
+            return;
+        }
+        
+        // mode=distance (default) or hops; max_legs 1-4; limit 1-20;
+        // same_airline=1; exclude=AAA,BBB
+        ItineraryQuery query;
+        if (req.get_param_value("mode") == "hops") {
+            query.order = ItineraryQuery::Order::kFewestLegs;
+        }
+        std::string legsStr = req.get_param_value("max_legs");
+        if (!legsStr.empty()) {
+            try {
+                int legs = std::stoi(legsStr);
+                query.max_legs = static_cast<size_t>(std::min(std::max(legs, 1), 4));
+            } catch (...) {}
+        }
+        std::string limitStr = req.get_param_value("limit");
+        if (!limitStr.empty()) {
+            try {
+                int limit = std::stoi(limitStr);
+                query.limit = static_cast<size_t>(std::min(std::max(limit, 1), 20));
+            } catch (...) {}
+        }
+        std::string sameStr = req.get_param_value("same_airline");
+        query.same_airline = sameStr == "1" || sameStr == "true";
+        std::string excludeStr = req.get_param_value("exclude");
+        for (size_t first = 0; first < excludeStr.size();) {
+            size_t comma = excludeStr.find(',', first);
+            if (comma == std::string::npos) comma = excludeStr.size();
+            IataCode code;
+            if (IataCode::parse(std::string_view(excludeStr).substr(first, comma - first), code)) {
+                query.excluded.push_back(code);
+            }
+            first = comma + 1;
+        }
+        
+        ItineraryResult found = db.findItineraries(source, dest, query);
+        const auto& itineraries = found.itineraries;
+        
+        std::ostringstream oss;
+        oss << "{"
+            << "\"source\":" << airportToJSON(source_airport) << ","
+            << "\"dest\":" << airportToJSON(dest_airport) << ","
+            << "\"itineraries\":[";
+        for (size_t i = 0; i < itineraries.size(); ++i) {
+            if (i > 0) oss << ",";
+            oss << "{"
+                << "\"distance\":" << std::fixed << std::setprecision(2) << itineraries[i].miles << ","
+                << "\"legs\":[";
+            const auto& legs = itineraries[i].legs;
+            for (size_t j = 0; j < legs.size(); ++j) {
+                if (j > 0) oss << ",";
+                oss << "{"
+                    << "\"from\":\"" << legs[j].from.str() << "\","
+                    << "\"to\":\"" << legs[j].to.str() << "\","
+                    << "\"airlines\":[";
+                for (size_t k = 0; k < legs[j].airlines.size(); ++k) {
+                    if (k > 0) oss << ",";
+                    oss << "\"" << legs[j].airlines[k].str() << "\"";
+                }
+                oss << "],"
+                    << "\"distance\":" << std::fixed << std::setprecision(2) << legs[j].miles
+                    << "}";
+            }
+            oss << "]}";
+        }
+        oss << "],\"truncated\":" << (found.truncated ? "true" : "false") << "}";
+        res.set_content(oss.str(), "application/json");
+    }));
+    
+    // Batch reachability: can each pair connect within max_hops flights
+    // (1-3, default 3)? Body: {"max_hops":2,"pairs":[["SFO","LHR"],...]}
+    svr.Post("/reachability", withDatabase(live, [](const Database& db, const httplib::Request& req, httplib::Response& res) {
+        const size_t kMaxPairs = 100000;
+        std::vector<std::pair<IataCode, IataCode>> pairs;
+        if (!getJSONCodePairs(req.body, "pairs", pairs) || pairs.size() > kMaxPairs) {
+            res.status = 400;
+            res.set_content("{\"error\":\"Expected pairs: up to " + std::to_string(kMaxPairs) +
+                            " [source, dest] IATA code pairs\"}", "application/json");
+            return;
+        }
+        int max_hops = getJSONInt(req.body, "max_hops", ReachabilityIndex::kMaxHops);
+        max_hops = std::min(std::max(max_hops, 1), static_cast<int>(ReachabilityIndex::kMaxHops));
+        
+        auto hops = db.hopCounts(pairs);
+        
+        std::ostringstream oss;
+        oss << "{\"max_hops\":" << max_hops << ",\"results\":[";
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            if (i > 0) oss << ",";
+            bool reachable = hops[i] <= static_cast<uint32_t>(max_hops);
+            oss << "{"
+                << "\"source\":\"" << pairs[i].first.str() << "\","
+                << "\"dest\":\"" << pairs[i].second.str() << "\","
+                << "\"reachable\":" << (reachable ? "true" : "false") << ","
+                << "\"hops\":";
+            if (reachable) {
+                oss << hops[i];
+            } else {
+                oss << "null";
+            }
+            oss << "}";
+        }
+        oss << "]}";
+        res.set_content(oss.str(), "application/json");
+    }));
     
     // Data update endpoints
     // Insert Airline
-    svr.Post("/airline/insert", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Post("/airline/insert", withWritableDatabase(live, [](Database& db, const httplib::Request& req) {
         Airline airline;
         airline.id = getJSONInt(req.body, "id", 0);
         airline.name = getJSONValue(req.body, "name");
@@ -2980,15 +3250,11 @@ int main() {
         airline.active = getJSONValue(req.body, "active");
         if (airline.active.empty()) airline.active = "Y";
         
-        auto result = db.insertAirline(airline);
-        std::ostringstream oss;
-        oss << "{\"success\":" << (result.success ? "true" : "false") 
-            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
-        res.set_content(oss.str(), "application/json");
-    });
+        return db.insertAirline(airline);
+    }));
     
     // Update Airline
-    svr.Post("/airline/:iata/update", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Post("/airline/:iata/update", withWritableDatabase(live, [](Database& db, const httplib::Request& req) {
         std::string iata = req.path_params.at("iata");
         Airline updates;
         updates.id = getJSONInt(req.body, "id", 0);
@@ -2999,25 +3265,17 @@ int main() {
         updates.country = getJSONValue(req.body, "country");
         updates.active = getJSONValue(req.body, "active");
         
-        auto result = db.updateAirline(iata, updates);
-        std::ostringstream oss;
-        oss << "{\"success\":" << (result.success ? "true" : "false") 
-            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
-        res.set_content(oss.str(), "application/json");
-    });
+        return db.updateAirline(iata, updates);
+    }));
     
     // Delete Airline
-    svr.Delete("/airline/:iata", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Delete("/airline/:iata", withWritableDatabase(live, [](Database& db, const httplib::Request& req) {
         std::string iata = req.path_params.at("iata");
-        auto result = db.deleteAirline(iata);
-        std::ostringstream oss;
-        oss << "{\"success\":" << (result.success ? "true" : "false") 
-            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
-        res.set_content(oss.str(), "application/json");
-    });
+        return db.deleteAirline(iata);
+    }));
     
     // Insert Airport
-    svr.Post("/airport/insert", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Post("/airport/insert", withWritableDatabase(live, [](Database& db, const httplib::Request& req) {
         Airport airport;
         airport.id = getJSONInt(req.body, "id", 0);
         airport.name = getJSONValue(req.body, "name");
@@ -3034,15 +3292,11 @@ int main() {
         airport.type = getJSONValue(req.body, "type");
         airport.source = getJSONValue(req.body, "source");
         
-        auto result = db.insertAirport(airport);
-        std::ostringstream oss;
-        oss << "{\"success\":" << (result.success ? "true" : "false") 
-            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
-        res.set_content(oss.str(), "application/json");
-    });
+        return db.insertAirport(airport);
+    }));
     
     // Update Airport
-    svr.Post("/airport/:iata/update", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Post("/airport/:iata/update", withWritableDatabase(live, [](Database& db, const httplib::Request& req) {
         std::string iata = req.path_params.at("iata");
         Airport updates;
         updates.id = getJSONInt(req.body, "id", 0);
@@ -3059,25 +3313,17 @@ int main() {
         updates.type = getJSONValue(req.body, "type");
         updates.source = getJSONValue(req.body, "source");
         
-        auto result = db.updateAirport(iata, updates);
-        std::ostringstream oss;
-        oss << "{\"success\":" << (result.success ? "true" : "false") 
-            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
-        res.set_content(oss.str(), "application/json");
-    });
+        return db.updateAirport(iata, updates);
+    }));
     
     // Delete Airport
-    svr.Delete("/airport/:iata", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Delete("/airport/:iata", withWritableDatabase(live, [](Database& db, const httplib::Request& req) {
         std::string iata = req.path_params.at("iata");
-        auto result = db.deleteAirport(iata);
-        std::ostringstream oss;
-        oss << "{\"success\":" << (result.success ? "true" : "false") 
-            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
-        res.set_content(oss.str(), "application/json");
-    });
+        return db.deleteAirport(iata);
+    }));
     
     // Insert Route
-    svr.Post("/route/insert", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Post("/route/insert", withWritableDatabase(live, [](Database& db, const httplib::Request& req) {
         Route route;
         route.airline_iata = getJSONValue(req.body, "airline_iata");
         route.airline_id = getJSONInt(req.body, "airline_id", -1);
@@ -3089,29 +3335,25 @@ int main() {
         route.stops = getJSONInt(req.body, "stops", 0);
         route.equipment = getJSONValue(req.body, "equipment");
         
-        // Look up IDs if not provided
+        // Look up IDs if not provided; insertRoute rejects codes that are too long
         if (route.airline_id <= 0 && !route.airline_iata.empty()) {
-            Airline airline = db.getAirlineByIATA(route.airline_iata);
+            AirlineView airline = db.findAirline(IataCode(route.airline_iata));
             if (airline.id > 0) route.airline_id = airline.id;
         }
         if (route.source_id <= 0 && !route.source_iata.empty()) {
-            Airport airport = db.getAirportByIATA(route.source_iata);
+            AirportView airport = db.findAirport(IataCode(route.source_iata));
             if (airport.id > 0) route.source_id = airport.id;
         }
         if (route.dest_id <= 0 && !route.dest_iata.empty()) {
-            Airport airport = db.getAirportByIATA(route.dest_iata);
+            AirportView airport = db.findAirport(IataCode(route.dest_iata));
             if (airport.id > 0) route.dest_id = airport.id;
         }
         
-        auto result = db.insertRoute(route);
-        std::ostringstream oss;
-        oss << "{\"success\":" << (result.success ? "true" : "false") 
-            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
-        res.set_content(oss.str(), "application/json");
-    });
+        return db.insertRoute(route);
+    }));
     
     // Update Route
-    svr.Post("/route/:id/update", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Post("/route/:id/update", withWritableDatabase(live, [](Database& db, const httplib::Request& req) {
         int route_id = std::stoi(req.path_params.at("id"));
         Route updates;
         updates.airline_iata = getJSONValue(req.body, "airline_iata");
@@ -3121,23 +3363,56 @@ int main() {
         updates.stops = getJSONInt(req.body, "stops", -1);
         updates.equipment = getJSONValue(req.body, "equipment");
         
-        auto result = db.updateRoute(route_id, updates);
-        std::ostringstream oss;
-        oss << "{\"success\":" << (result.success ? "true" : "false") 
-            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
-        res.set_content(oss.str(), "application/json");
-    });
+        return db.updateRoute(route_id, updates);
+    }));
     
     // Delete Route
-    svr.Delete("/route/:id", [&db](const httplib::Request& req, httplib::Response& res) {
+    svr.Delete("/route/:id", withWritableDatabase(live, [](Database& db, const httplib::Request& req) {
         int route_id = std::stoi(req.path_params.at("id"));
-        auto result = db.deleteRoute(route_id);
+        return db.deleteRoute(route_id);
+    }));
+    
+    // Liveness: the process is up and serving HTTP
+    svr.Get("/healthz", [](const httplib::Request&, httplib::Response& res) {
+        res.set_content("{\"status\":\"ok\"}", "application/json");
+    });
+    
+    // Readiness: 503 with load progress until the database is published
+    svr.Get("/readyz", [&live, &progress, &reloader](const httplib::Request&, httplib::Response& res) {
+        bool ready = live.ready();
         std::ostringstream oss;
-        oss << "{\"success\":" << (result.success ? "true" : "false") 
-            << ",\"message\":\"" << escapeJSON(result.message) << "\"}";
+        oss << "{\"ready\":" << (ready ? "true" : "false")
+            << ",\"generation\":" << live.generation()
+            << ",\"reloading\":" << (reloader.reloading() ? "true" : "false")
+            << ",\"bytesParsed\":" << progress.bytes_parsed.load(std::memory_order_relaxed)
+            << ",\"bytesTotal\":" << progress.bytes_total.load(std::memory_order_relaxed)
+            << ",\"airlines\":" << progress.airlines.load(std::memory_order_relaxed)
+            << ",\"airports\":" << progress.airports.load(std::memory_order_relaxed)
+            << ",\"routes\":" << progress.routes.load(std::memory_order_relaxed)
+            << "}";
+        if (!ready) res.status = 503;
         res.set_content(oss.str(), "application/json");
     });
     
+    // Rebuild from the .dat files in the background and swap atomically;
+    // in-flight requests finish on the old data
+    svr.Post("/admin/reload", [&reloader](const httplib::Request&, httplib::Response& res) {
+        reloader.requestReload();
+        res.status = 202;
+        res.set_content("{\"success\":true,\"message\":\"Reload scheduled\"}", "application/json");
+    });
+    
+    // Phase timings, peak RSS and row counts from the most recent load
+    svr.Get("/admin/load-report", [&last_report](const httplib::Request&, httplib::Response& res) {
+        std::shared_ptr<const LoadReport> report = std::atomic_load(&last_report);
+        if (!report) {
+            res.status = 503;
+            res.set_content("{\"error\":\"No load has finished yet\"}", "application/json");
+            return;
+        }
+        res.set_content(report->toJSON(), "application/json");
+    });
+    
     // Start server - use PORT environment variable if available, otherwise default to 8080
     const char* port_env = std::getenv("PORT");
     int port = port_env ? std::atoi(port_env) : 8080;
@@ -3146,6 +3421,9 @@ int main() {
     std::cout << "Starting server on http://0.0.0.0:" << port << std::endl;
     svr.listen("0.0.0.0", port);
     
+    if (loader.joinable()) {
+        loader.join();
+    }
     return 0;
 }
 
@@ -0,0 +1,97 @@
+#include "../include/mapped_file.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        buffer_ = std::move(other.buffer_);
+        mapped_ = other.mapped_;
+        open_ = other.open_;
+        size_ = other.size_;
+        data_ = mapped_ ? other.data_ : buffer_.data();
+        other.data_ = nullptr;
+        other.size_ = 0;
+        other.mapped_ = false;
+        other.open_ = false;
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ == 0) {
+            // mmap rejects zero-length mappings; an empty file is still valid
+            ::close(fd);
+            open_ = true;
+            return true;
+        }
+#ifdef MAP_POPULATE
+        // Fault every page in here, so file I/O is paid (and timed) at open
+        // rather than scattered through parsing
+        int flags = MAP_PRIVATE | MAP_POPULATE;
+#else
+        int flags = MAP_PRIVATE;
+#endif
+        void* addr = mmap(nullptr, size_, PROT_READ, flags, fd, 0);
+        if (addr != MAP_FAILED) {
+            // Loaders scan front to back exactly once
+            madvise(addr, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(addr);
+            mapped_ = true;
+            open_ = true;
+            ::close(fd);
+            return true;
+        }
+        size_ = 0;
+    }
+
+    // Fallback: read everything into an owned buffer
+    char chunk[65536];
+    ssize_t n;
+    while ((n = ::read(fd, chunk, sizeof(chunk))) > 0) {
+        buffer_.append(chunk, static_cast<size_t>(n));
+    }
+    ::close(fd);
+    if (n < 0) {
+        buffer_.clear();
+        return false;
+    }
+
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+    open_ = true;
+    return true;
+}
+
+void MappedFile::close() {
+    if (mapped_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+    buffer_.clear();
+    buffer_.shrink_to_fit();
+    data_ = nullptr;
+    size_ = 0;
+    mapped_ = false;
+    open_ = false;
+}
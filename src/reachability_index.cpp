@@ -0,0 +1,153 @@
+#include "../include/reachability_index.h"
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+// Graphs with fewer airports build each level on a single thread
+const size_t kParallelAirports = 2048;
+
+} // namespace
+
+void ReachabilityIndex::build(const CsrIndex& routes_by_source, size_t airports,
+                              const Usable& usable) {
+    airports_ = airports;
+    words_ = (airports + 63) / 64;
+    bits_.assign(kMaxHops * airports_ * words_, 0);
+
+    // Every row of a level reads only the level below, so a level splits
+    // into independent ranges of airports
+    size_t threads = 1;
+    if (airports_ >= kParallelAirports) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (uint32_t level = 0; level < kMaxHops; ++level) {
+        auto computeRange = [&, level](size_t first, size_t last) {
+            for (size_t a = first; a < last; ++a) {
+                computeRow(level, static_cast<uint32_t>(a), routes_by_source, usable);
+            }
+        };
+        size_t per_thread = (airports_ + threads - 1) / threads;
+        std::vector<std::thread> workers;
+        for (size_t first = per_thread; first < airports_; first += per_thread) {
+            workers.emplace_back(computeRange, first, std::min(airports_, first + per_thread));
+        }
+        computeRange(0, std::min(airports_, per_thread));
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+bool ReachabilityIndex::assign(size_t airports, std::vector<uint64_t> bits) {
+    size_t words = (airports + 63) / 64;
+    if (bits.size() != kMaxHops * airports * words) {
+        return false;
+    }
+    airports_ = airports;
+    words_ = words;
+    bits_ = std::move(bits);
+    return true;
+}
+
+void ReachabilityIndex::grow(size_t airports) {
+    if (airports <= airports_) {
+        return;
+    }
+    size_t words = (airports + 63) / 64;
+    std::vector<uint64_t> bits(kMaxHops * airports * words, 0);
+    for (uint32_t level = 0; level < kMaxHops; ++level) {
+        for (size_t a = 0; a < airports_; ++a) {
+            const uint64_t* from = row(level, static_cast<uint32_t>(a));
+            std::copy(from, from + words_, bits.begin() + (level * airports + a) * words);
+        }
+    }
+    airports_ = airports;
+    words_ = words;
+    bits_.swap(bits);
+}
+
+uint32_t ReachabilityIndex::hops(uint32_t from, uint32_t to) const {
+    if (from >= airports_ || to >= airports_) {
+        return kUnreachable;
+    }
+    return from == to ? 0 : distance(from, to, kMaxHops);
+}
+
+uint32_t ReachabilityIndex::distance(uint32_t from, uint32_t to, uint32_t levels) const {
+    for (uint32_t level = 0; level < levels; ++level) {
+        if (reaches(level, from, to)) {
+            return level + 1;
+        }
+    }
+    return kUnreachable;
+}
+
+void ReachabilityIndex::addLink(uint32_t from, uint32_t to) {
+    // An airport d flights from `from` now also reaches `to` in d + 1, and
+    // what `to` reaches in h flights in d + 1 + h. Walks that use the new
+    // link twice are never shorter than one that uses it once, so reading
+    // rows this loop has already updated adds nothing wrong.
+    if (from >= airports_ || to >= airports_) {
+        return;
+    }
+    for (uint32_t a = 0; a < airports_; ++a) {
+        uint32_t d = a == from ? 0 : distance(a, from, kMaxHops - 1);
+        if (d == kUnreachable) {
+            continue;
+        }
+        // Highest level first, so a == to reads its own lower levels
+        // before they change
+        for (uint32_t level = kMaxHops; level-- > d;) {
+            uint64_t* out = row(level, a);
+            out[to / 64] |= uint64_t(1) << (to % 64);
+            if (level > d) {
+                const uint64_t* beyond = row(level - d - 1, to);
+                for (size_t w = 0; w < words_; ++w) {
+                    out[w] |= beyond[w];
+                }
+            }
+        }
+    }
+}
+
+void ReachabilityIndex::removeLink(uint32_t from, const CsrIndex& routes_by_source,
+                                   const Usable& usable) {
+    // Only rows that reach `from` with flights to spare can have used the
+    // link. Levels go up so each recomputed row reads final rows below.
+    if (from >= airports_) {
+        return;
+    }
+    computeRow(0, from, routes_by_source, usable);
+    for (uint32_t level = 1; level < kMaxHops; ++level) {
+        for (uint32_t a = 0; a < airports_; ++a) {
+            if (a == from || reaches(level - 1, a, from)) {
+                computeRow(level, a, routes_by_source, usable);
+            }
+        }
+    }
+}
+
+void ReachabilityIndex::computeRow(uint32_t level, uint32_t airport,
+                                   const CsrIndex& routes_by_source, const Usable& usable) {
+    uint64_t* out = row(level, airport);
+    std::fill(out, out + words_, 0);
+    if (!usable(airport)) {
+        return;
+    }
+    // Neighbor runs are sorted, so each destination is visited once
+    IdSpan next = routes_by_source.neighbors(airport);
+    for (size_t i = 0; i < next.size(); ++i) {
+        uint32_t b = next[i];
+        if ((i > 0 && next[i - 1] == b) || b >= airports_ || !usable(b)) {
+            continue;
+        }
+        out[b / 64] |= uint64_t(1) << (b % 64);
+        if (level > 0) {
+            const uint64_t* below = row(level - 1, b);
+            for (size_t w = 0; w < words_; ++w) {
+                out[w] |= below[w];
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#include "../include/route_table.h"
+#include <algorithm>
+
+namespace {
+
+// Route::stops is an int; the table keeps one byte (real data has 0 or 1)
+uint8_t clampStops(int stops) {
+    return static_cast<uint8_t>(std::min(std::max(stops, 0), 255));
+}
+
+} // namespace
+
+void RouteTable::reserve(size_t n) {
+    airline_.reserve(n);
+    source_.reserve(n);
+    dest_.reserve(n);
+    equipment_.reserve(n);
+    airline_id_.reserve(n);
+    source_id_.reserve(n);
+    dest_id_.reserve(n);
+    stops_.reserve(n);
+    codeshare_.reserve(n);
+    miles_.reserve(n);
+}
+
+void RouteTable::append(const Route& route) {
+    Row row;
+    row.airline = internAirline(IataCode(route.airline_iata));
+    row.source = internAirport(IataCode(route.source_iata));
+    row.dest = internAirport(IataCode(route.dest_iata));
+    row.equipment = internEquipment(route.equipment);
+    row.airline_id = route.airline_id;
+    row.source_id = route.source_id;
+    row.dest_id = route.dest_id;
+    row.stops = clampStops(route.stops);
+    row.codeshare = route.codeshare == "Y";
+    appendRow(row);
+}
+
+void RouteTable::appendRow(const Row& row) {
+    airline_.push_back(row.airline);
+    source_.push_back(row.source);
+    dest_.push_back(row.dest);
+    equipment_.push_back(row.equipment);
+    airline_id_.push_back(row.airline_id);
+    source_id_.push_back(row.source_id);
+    dest_id_.push_back(row.dest_id);
+    stops_.push_back(row.stops);
+    codeshare_.push_back(row.codeshare ? 1 : 0);
+    miles_.push_back(0.0);
+}
+
+RouteTable::Row RouteTable::row(size_t i) const {
+    Row row;
+    row.airline = airline_[i];
+    row.source = source_[i];
+    row.dest = dest_[i];
+    row.equipment = equipment_[i];
+    row.airline_id = airline_id_[i];
+    row.source_id = source_id_[i];
+    row.dest_id = dest_id_[i];
+    row.stops = stops_[i];
+    row.codeshare = codeshare_[i] != 0;
+    return row;
+}
+
+Route RouteTable::get(size_t i) const {
+    Route route;
+    route.airline_iata = airline_codes_.at(airline_[i]).str();
+    route.airline_id = airline_id_[i];
+    route.source_iata = airport_codes_.at(source_[i]).str();
+    route.source_id = source_id_[i];
+    route.dest_iata = airport_codes_.at(dest_[i]).str();
+    route.dest_id = dest_id_[i];
+    route.codeshare = codeshare_[i] ? "Y" : "";
+    route.stops = stops_[i];
+    route.equipment = equipment_names_.at(equipment_[i]);
+    return route;
+}
+
+void RouteTable::set(size_t i, const Route& route) {
+    airline_[i] = internAirline(IataCode(route.airline_iata));
+    source_[i] = internAirport(IataCode(route.source_iata));
+    dest_[i] = internAirport(IataCode(route.dest_iata));
+    equipment_[i] = internEquipment(route.equipment);
+    airline_id_[i] = route.airline_id;
+    source_id_[i] = route.source_id;
+    dest_id_[i] = route.dest_id;
+    stops_[i] = clampStops(route.stops);
+    codeshare_[i] = route.codeshare == "Y" ? 1 : 0;
+}
+
+void RouteTable::erase(size_t i) {
+    eraseIf([i](size_t j) { return j == i; });
+}
+
+void RouteTable::moveRow(size_t to, size_t from) {
+    if (to == from) {
+        return;
+    }
+    airline_[to] = airline_[from];
+    source_[to] = source_[from];
+    dest_[to] = dest_[from];
+    equipment_[to] = equipment_[from];
+    airline_id_[to] = airline_id_[from];
+    source_id_[to] = source_id_[from];
+    dest_id_[to] = dest_id_[from];
+    stops_[to] = stops_[from];
+    codeshare_[to] = codeshare_[from];
+    miles_[to] = miles_[from];
+}
+
+void RouteTable::resize(size_t n) {
+    airline_.resize(n);
+    source_.resize(n);
+    dest_.resize(n);
+    equipment_.resize(n);
+    airline_id_.resize(n);
+    source_id_.resize(n);
+    dest_id_.resize(n);
+    stops_.resize(n);
+    codeshare_.resize(n);
+    miles_.resize(n);
+}
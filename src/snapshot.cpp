@@ -0,0 +1,687 @@
+#include "../include/database.h"
+#include "../include/mapped_file.h"
+#include "../include/load_progress.h"
+#include "../include/load_report.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Binary snapshot of a fully loaded Database.
+//
+// Layout (host byte order, checked through kEndianTag):
+//   SnapshotHeader
+//   payload: one blob per Section, at header.sections[s].offset
+//
+// Strings live in the Strings section and records refer to them by
+// offset/length. Airline and airport text is each table's StringArena
+// copied as one block; other strings are stored once each. Routes are
+// stored as they are held in memory: rows of dense indices plus the
+// dictionaries (packed IataCodes, equipment names) that map those indices
+// back.
+//
+// Every derived structure is stored too: route lengths, airport
+// positions, the CSR route indexes, both count matrices, the traffic
+// ranking, the reachability bitsets and the airport name index. Each is
+// written as its arrays (a uint64 count, then the elements), so a load
+// copies them back in one pass each and rebuilds nothing.
+
+namespace {
+
+const char kSnapshotMagic[8] = {'A', 'T', 'D', 'B', 'S', 'N', 'A', 'P'};
+const uint32_t kSnapshotVersion = 4;
+const uint32_t kEndianTag = 0x01020304;
+
+enum Section : uint32_t {
+    kStrings,
+    kAirlines,
+    kAirlineIataIndex,
+    kAirports,
+    kAirportIataIndex,
+    kAirlineCodes,
+    kAirportCodes,
+    kEquipment,
+    kRoutes,
+    kRouteMiles,
+    kAirportGeo,
+    kRoutesBySource,
+    kRoutesByDest,
+    kRoutesByAirline,
+    kAirportsByAirline,
+    kAirlinesByAirport,
+    kAirportTraffic,
+    kReachability,
+    kAirportSearch,
+    kSectionCount
+};
+
+struct SectionEntry {
+    uint64_t offset; // From the start of the payload
+    uint64_t size;
+};
+
+struct SourceStamp {
+    uint64_t size;
+    int64_t mtime_ns;
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian_tag;
+    uint32_t source_count;
+    uint32_t reserved;
+    SourceStamp sources[8];
+    uint64_t payload_size;
+    uint64_t checksum;
+    SectionEntry sections[kSectionCount];
+};
+
+struct AirlineRecord {
+    int32_t id;
+    StrRef name, alias, iata, icao, callsign, country, active;
+};
+
+struct AirportRecord {
+    double latitude;
+    double longitude;
+    double timezone;
+    int32_t id;
+    int32_t altitude;
+    StrRef name, city, country, iata, icao, dst, tz, type, source;
+};
+
+struct RouteRecord {
+    uint32_t airline, source, dest, equipment; // Dense dictionary indices
+    int32_t airline_id, source_id, dest_id;
+    uint8_t stops, codeshare;
+    uint8_t reserved[2];
+};
+
+// One doc of the airport name index: its code and lowercase name
+struct SearchDocRecord {
+    uint32_t code;
+    StrRef name;
+};
+
+static_assert(std::is_trivially_copyable<SnapshotHeader>::value, "header must be POD");
+static_assert(std::is_trivially_copyable<AirportRecord>::value, "records must be POD");
+static_assert(sizeof(RouteRecord) == 32, "RouteRecord must have no implicit padding");
+
+// 64-bit multiply/xorshift hash over 8-byte words; only guards against
+// truncated or corrupted files, not against tampering. Runs of four words
+// go to independent lanes, so the multiplies overlap instead of each one
+// waiting on the last.
+uint64_t checksum64(const char* data, size_t size) {
+    uint64_t lanes[4] = {0x9E3779B97F4A7C15ull ^ size, 0xC2B2AE3D27D4EB4Full,
+                         0x165667B19E3779F9ull, 0x27D4EB2F165667C5ull};
+    size_t i = 0;
+    for (; i + 32 <= size; i += 32) {
+        for (int l = 0; l < 4; ++l) {
+            uint64_t w;
+            std::memcpy(&w, data + i + 8 * l, 8);
+            lanes[l] = (lanes[l] ^ w) * 0xFF51AFD7ED558CCDull;
+            lanes[l] ^= lanes[l] >> 32;
+        }
+    }
+    uint64_t h = lanes[0];
+    for (int l = 1; l < 4; ++l) {
+        h = (h ^ lanes[l]) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    for (; i + 8 <= size; i += 8) {
+        uint64_t w;
+        std::memcpy(&w, data + i, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ static_cast<unsigned char>(data[i])) * 0xC4CEB9FE1A85EC53ull;
+    }
+    return h ^ (h >> 29);
+}
+
+bool stampSources(const std::vector<std::string>& sources, SnapshotHeader& header) {
+    if (sources.size() > sizeof(header.sources) / sizeof(header.sources[0])) {
+        return false;
+    }
+    header.source_count = static_cast<uint32_t>(sources.size());
+    for (size_t i = 0; i < sources.size(); ++i) {
+        struct stat st;
+        if (stat(sources[i].c_str(), &st) != 0) {
+            return false;
+        }
+        header.sources[i].size = static_cast<uint64_t>(st.st_size);
+        header.sources[i].mtime_ns = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    }
+    return true;
+}
+
+// write() until every byte is out or an error other than EINTR
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+class SnapshotWriter {
+public:
+    StrRef str(const std::string& s) {
+        auto it = offsets_.find(s);
+        if (it != offsets_.end()) {
+            return StrRef{it->second, static_cast<uint32_t>(s.size())};
+        }
+        uint32_t offset = static_cast<uint32_t>(blobs_[kStrings].size());
+        blobs_[kStrings] += s;
+        offsets_.emplace(s, offset);
+        return StrRef{offset, static_cast<uint32_t>(s.size())};
+    }
+
+    // Appends a block of strings as is, e.g. a StringArena, and returns
+    // its offset in the Strings section
+    uint32_t strings(const std::string& block) {
+        uint32_t offset = static_cast<uint32_t>(blobs_[kStrings].size());
+        blobs_[kStrings] += block;
+        return offset;
+    }
+
+    template <typename T>
+    void put(Section section, const T& value) {
+        blobs_[section].append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // A uint64 count, then the elements as they are in memory
+    template <typename T>
+    void putArray(Section section, const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value, "arrays must be POD");
+        put(section, static_cast<uint64_t>(values.size()));
+        blobs_[section].append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+    }
+
+    bool write(const std::string& path, SnapshotHeader& header) {
+        std::string payload;
+        for (uint32_t s = 0; s < kSectionCount; ++s) {
+            // Keep every section 8-byte aligned inside the payload
+            payload.resize((payload.size() + 7) & ~size_t(7), '\0');
+            header.sections[s].offset = payload.size();
+            header.sections[s].size = blobs_[s].size();
+            payload += blobs_[s];
+        }
+        header.payload_size = payload.size();
+        header.checksum = checksum64(payload.data(), payload.size());
+
+        // Write a uniquely named file beside the target, flush it to disk and
+        // rename it over the target, so readers never see a partial file and
+        // concurrent saves never share a temporary
+        std::string tmp = path + ".tmp.XXXXXX";
+        int fd = ::mkstemp(&tmp[0]);
+        if (fd < 0) {
+            return false;
+        }
+        // mkstemp creates the file owner-only; snapshots are as readable as
+        // the data files
+        bool ok = ::fchmod(fd, 0644) == 0 &&
+                  writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+                  writeAll(fd, payload.data(), payload.size()) && ::fsync(fd) == 0;
+        ok = ::close(fd) == 0 && ok;
+        if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+            std::remove(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+private:
+    std::string blobs_[kSectionCount];
+    std::unordered_map<std::string, uint32_t> offsets_;
+};
+
+StrRef rebase(StrRef ref, uint32_t base) {
+    return StrRef{ref.offset + base, ref.length};
+}
+
+// Bounds-checked cursor over one payload section
+class SectionReader {
+public:
+    SectionReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (size_ - pos_ < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return true;
+    }
+
+    // An array written by SnapshotWriter::putArray()
+    template <typename T>
+    bool getArray(std::vector<T>& values) {
+        uint64_t count;
+        if (!get(count) || count > remaining() / sizeof(T)) {
+            return false;
+        }
+        values.resize(count);
+        std::memcpy(values.data(), data_ + pos_, count * sizeof(T));
+        pos_ += count * sizeof(T);
+        return true;
+    }
+
+    size_t remaining() const { return size_ - pos_; }
+
+private:
+    const char* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+void putIndex(SnapshotWriter& writer, Section section, const CsrIndex& index) {
+    writer.put(section, static_cast<uint64_t>(index.hasNeighbors() ? 1 : 0));
+    writer.putArray(section, index.offsetArray());
+    writer.putArray(section, index.rowArray());
+    writer.putArray(section, index.neighborArray());
+}
+
+bool getIndex(SectionReader reader, CsrIndex& index, size_t row_count, size_t neighbor_count) {
+    uint64_t has_neighbors;
+    std::vector<uint32_t> offsets, rows, neighbors;
+    return reader.get(has_neighbors) && reader.getArray(offsets) && reader.getArray(rows) &&
+           reader.getArray(neighbors) && reader.remaining() == 0 &&
+           index.assign(std::move(offsets), std::move(rows), std::move(neighbors),
+                        has_neighbors != 0, row_count, neighbor_count);
+}
+
+void putMatrix(SnapshotWriter& writer, Section section, const CountMatrix& matrix) {
+    writer.putArray(section, matrix.offsetArray());
+    writer.putArray(section, matrix.cellArray());
+    writer.putArray(section, matrix.colOrder());
+}
+
+bool getMatrix(SectionReader reader, CountMatrix& matrix, size_t col_count) {
+    std::vector<uint32_t> offsets, col_order;
+    std::vector<CountCell> cells;
+    return reader.getArray(offsets) && reader.getArray(cells) && reader.getArray(col_order) &&
+           reader.remaining() == 0 &&
+           matrix.assign(std::move(offsets), std::move(cells), std::move(col_order), col_count);
+}
+
+} // namespace
+
+bool Database::saveSnapshot(const std::string& path, const std::vector<std::string>& sources) const {
+    auto started = std::chrono::steady_clock::now();
+    SnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic));
+    header.version = kSnapshotVersion;
+    header.endian_tag = kEndianTag;
+    if (!stampSources(sources, header)) {
+        return false;
+    }
+
+    SnapshotWriter writer;
+
+    // Airlines: every row of the entity table (a superset of the IATA
+    // index, which keeps only the last airline seen per code), then the
+    // IATA index as row numbers in sorted order. The table's string arena
+    // is written as one block, so its rows only need their refs offset.
+    uint32_t base = writer.strings(airlines.arena().data());
+    for (uint32_t row = 0; row < airlines.size(); ++row) {
+        const AirlineRow& a = airlines.row(row);
+        writer.put(kAirlines, AirlineRecord{a.id, rebase(a.name, base), rebase(a.alias, base),
+            rebase(a.iata, base), rebase(a.icao, base), rebase(a.callsign, base),
+            rebase(a.country, base), rebase(a.active, base)});
+    }
+    for (uint32_t row : airlines.sorted().rows()) {
+        writer.put(kAirlineIataIndex, row);
+    }
+
+    base = writer.strings(airports.arena().data());
+    for (uint32_t row = 0; row < airports.size(); ++row) {
+        const AirportRow& a = airports.row(row);
+        writer.put(kAirports, AirportRecord{a.latitude, a.longitude, a.timezone, a.id, a.altitude,
+            rebase(a.name, base), rebase(a.city, base), rebase(a.country, base),
+            rebase(a.iata, base), rebase(a.icao, base), rebase(a.dst, base), rebase(a.tz, base),
+            rebase(a.type, base), rebase(a.source, base)});
+    }
+    for (uint32_t row : airports.sorted().rows()) {
+        writer.put(kAirportIataIndex, row);
+    }
+
+    for (size_t a = 0; a < routes.airlineCodes().size(); ++a) {
+        writer.put(kAirlineCodes, routes.airlineCodes().at(static_cast<uint32_t>(a)).raw());
+    }
+    for (size_t a = 0; a < routes.airportCodes().size(); ++a) {
+        writer.put(kAirportCodes, routes.airportCodes().at(static_cast<uint32_t>(a)).raw());
+    }
+    for (size_t e = 0; e < routes.equipmentNames().size(); ++e) {
+        writer.put(kEquipment, writer.str(routes.equipmentNames().at(static_cast<uint32_t>(e))));
+    }
+    for (size_t r = 0; r < routes.size(); ++r) {
+        RouteTable::Row row = routes.row(r);
+        writer.put(kRoutes, RouteRecord{row.airline, row.source, row.dest, row.equipment,
+            row.airline_id, row.source_id, row.dest_id, row.stops,
+            static_cast<uint8_t>(row.codeshare ? 1 : 0), {0, 0}});
+    }
+
+    // Derived structures, as they are held in memory
+    std::vector<double> miles(routes.size());
+    for (size_t r = 0; r < routes.size(); ++r) {
+        miles[r] = routes.miles(r);
+    }
+    writer.putArray(kRouteMiles, miles);
+    writer.putArray(kAirportGeo, airport_geo);
+    putIndex(writer, kRoutesBySource, routes_by_source);
+    putIndex(writer, kRoutesByDest, routes_by_dest);
+    putIndex(writer, kRoutesByAirline, routes_by_airline);
+    putMatrix(writer, kAirportsByAirline, airports_by_airline);
+    putMatrix(writer, kAirlinesByAirport, airlines_by_airport);
+    writer.putArray(kAirportTraffic, airport_traffic.entries());
+    writer.put(kReachability, static_cast<uint64_t>(reachability.size()));
+    writer.putArray(kReachability, reachability.bits());
+
+    // The name index: docs in slot order, then the posting lists in CSR
+    // form (trigrams, offsets, codes)
+    std::vector<SearchDocRecord> docs(airport_search.size());
+    for (size_t slot = 0; slot < docs.size(); ++slot) {
+        docs[slot] = SearchDocRecord{airport_search.docCode(slot).raw(),
+                                     writer.str(airport_search.docName(slot))};
+    }
+    std::vector<uint32_t> trigrams, posting_offsets(1, 0), posting_codes;
+    for (const auto& entry : airport_search.postings()) {
+        trigrams.push_back(entry.first);
+        posting_codes.insert(posting_codes.end(), entry.second.begin(), entry.second.end());
+        posting_offsets.push_back(static_cast<uint32_t>(posting_codes.size()));
+    }
+    writer.putArray(kAirportSearch, docs);
+    writer.putArray(kAirportSearch, trigrams);
+    writer.putArray(kAirportSearch, posting_offsets);
+    writer.putArray(kAirportSearch, posting_codes);
+
+    if (!writer.write(path, header)) {
+        return false;
+    }
+    if (report_) {
+        report_->addStep("snapshot write", std::chrono::steady_clock::now() - started);
+    }
+    return true;
+}
+
+bool Database::loadSnapshot(const std::string& path, const std::vector<std::string>& sources) {
+    auto started = std::chrono::steady_clock::now();
+    MappedFile file;
+    if (!file.open(path) || file.size() < sizeof(SnapshotHeader)) {
+        return false;
+    }
+
+    // Reject anything written by another build or against other .dat files
+    SnapshotHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+    SnapshotHeader current;
+    std::memset(&current, 0, sizeof(current));
+    if (std::memcmp(header.magic, kSnapshotMagic, sizeof(kSnapshotMagic)) != 0 ||
+        header.version != kSnapshotVersion ||
+        header.endian_tag != kEndianTag ||
+        !stampSources(sources, current) ||
+        header.source_count != current.source_count ||
+        std::memcmp(header.sources, current.sources, sizeof(SourceStamp) * current.source_count) != 0) {
+        return false;
+    }
+
+    const char* payload = file.data() + sizeof(SnapshotHeader);
+    if (header.payload_size != file.size() - sizeof(SnapshotHeader) ||
+        checksum64(payload, header.payload_size) != header.checksum) {
+        return false;
+    }
+    for (uint32_t s = 0; s < kSectionCount; ++s) {
+        if (header.sections[s].offset > header.payload_size ||
+            header.sections[s].size > header.payload_size - header.sections[s].offset) {
+            return false;
+        }
+    }
+
+    auto section = [&](Section s) {
+        return SectionReader(payload + header.sections[s].offset, header.sections[s].size);
+    };
+    const char* strings = payload + header.sections[kStrings].offset;
+    const uint64_t strings_size = header.sections[kStrings].size;
+    bool ok = true;
+    auto str = [&](StrRef ref) {
+        if (ref.offset > strings_size || ref.length > strings_size - ref.offset) {
+            ok = false;
+            return std::string();
+        }
+        return std::string(strings + ref.offset, ref.length);
+    };
+    // Moves a record's text into the arena of the table it is loaded into
+    auto copyText = [&](StrRef& ref, StringArena& arena) {
+        if (ref.offset > strings_size || ref.length > strings_size - ref.offset) {
+            ok = false;
+            ref = StrRef();
+            return;
+        }
+        ref = arena.add(std::string_view(strings + ref.offset, ref.length));
+    };
+
+    // Decode into locals and only replace the live tables once everything
+    // has been validated.
+    // Rows keep their stored order, so the index sections' row numbers
+    // apply unchanged; a repeated id would merge rows and is rejected
+    EntityTable<Airline> new_airlines;
+    SectionReader airline_reader = section(kAirlines);
+    new_airlines.reserve(airline_reader.remaining() / sizeof(AirlineRecord));
+    AirlineRecord ar;
+    while (airline_reader.get(ar)) {
+        AirlineRow row{ar.id, ar.name, ar.alias, ar.iata, ar.icao, ar.callsign, ar.country, ar.active};
+        EntityRows<Airline>::forEachText(row, [&](StrRef& ref) { copyText(ref, new_airlines.arena()); });
+        if (new_airlines.appendRow(row) + 1 != new_airlines.size()) {
+            return false;
+        }
+    }
+
+    EntityTable<Airport> new_airports;
+    SectionReader airport_reader = section(kAirports);
+    new_airports.reserve(airport_reader.remaining() / sizeof(AirportRecord));
+    AirportRecord pr;
+    while (airport_reader.get(pr)) {
+        AirportRow row{pr.latitude, pr.longitude, pr.timezone, pr.id, pr.altitude, pr.name,
+            pr.city, pr.country, pr.iata, pr.icao, pr.dst, pr.tz, pr.type, pr.source};
+        EntityRows<Airport>::forEachText(row, [&](StrRef& ref) { copyText(ref, new_airports.arena()); });
+        if (new_airports.appendRow(row) + 1 != new_airports.size()) {
+            return false;
+        }
+    }
+
+    // Dictionaries first: interning them in stored order reproduces the
+    // dense indices the route rows refer to
+    RouteTable new_routes;
+    SectionReader airline_codes = section(kAirlineCodes);
+    SectionReader airport_codes = section(kAirportCodes);
+    SectionReader equipment = section(kEquipment);
+    uint32_t raw_code;
+    size_t code_count = 0;
+    while (airline_codes.get(raw_code)) {
+        new_routes.internAirline(IataCode::fromRaw(raw_code));
+        ++code_count;
+    }
+    if (new_routes.airlineCodes().size() != code_count) {
+        return false;
+    }
+    code_count = 0;
+    while (airport_codes.get(raw_code)) {
+        new_routes.internAirport(IataCode::fromRaw(raw_code));
+        ++code_count;
+    }
+    if (new_routes.airportCodes().size() != code_count) {
+        return false;
+    }
+    StrRef equipment_ref;
+    code_count = 0;
+    while (equipment.get(equipment_ref)) {
+        new_routes.internEquipment(str(equipment_ref));
+        ++code_count;
+    }
+    if (new_routes.equipmentNames().size() != code_count) {
+        return false;
+    }
+
+    new_routes.reserve(header.sections[kRoutes].size / sizeof(RouteRecord));
+    SectionReader route_reader = section(kRoutes);
+    RouteRecord rr;
+    while (route_reader.get(rr)) {
+        if (rr.airline >= new_routes.airlineCodes().size() ||
+            rr.source >= new_routes.airportCodes().size() ||
+            rr.dest >= new_routes.airportCodes().size() ||
+            rr.equipment >= new_routes.equipmentNames().size()) {
+            return false;
+        }
+        new_routes.appendRow(RouteTable::Row{rr.airline, rr.source, rr.dest, rr.equipment,
+            rr.airline_id, rr.source_id, rr.dest_id, rr.stops, rr.codeshare != 0});
+    }
+    if (!ok || airline_reader.remaining() || airport_reader.remaining() || route_reader.remaining() ||
+        airline_codes.remaining() || airport_codes.remaining() || equipment.remaining()) {
+        return false;
+    }
+
+    SectionReader airline_index = section(kAirlineIataIndex);
+    uint32_t row;
+    while (airline_index.get(row)) {
+        if (row >= new_airlines.size()) {
+            return false;
+        }
+        new_airlines.setCode(new_airlines.code(row), row);
+    }
+
+    SectionReader airport_index = section(kAirportIataIndex);
+    while (airport_index.get(row)) {
+        if (row >= new_airports.size()) {
+            return false;
+        }
+        new_airports.setCode(new_airports.code(row), row);
+    }
+
+    // Derived structures go back as they were written; each assign()
+    // checks its arrays against the tables decoded above
+    const size_t airport_count = new_routes.airportCodes().size();
+    const size_t airline_count = new_routes.airlineCodes().size();
+    SectionReader miles_reader = section(kRouteMiles);
+    std::vector<double> miles;
+    if (!miles_reader.getArray(miles) || miles_reader.remaining() || miles.size() != new_routes.size()) {
+        return false;
+    }
+    for (size_t r = 0; r < miles.size(); ++r) {
+        new_routes.setMiles(r, miles[r]);
+    }
+    SectionReader geo_reader = section(kAirportGeo);
+    std::vector<GeoPoint> geo;
+    // Positions may stop short of the dictionary; growAirportGeo() fills
+    // in the rest once the airports are in place
+    if (!geo_reader.getArray(geo) || geo_reader.remaining() || geo.size() > airport_count) {
+        return false;
+    }
+
+    CsrIndex by_source, by_dest, by_airline;
+    CountMatrix airports_by, airlines_by;
+    if (!getIndex(section(kRoutesBySource), by_source, new_routes.size(), airport_count) ||
+        !getIndex(section(kRoutesByDest), by_dest, new_routes.size(), airport_count) ||
+        !getIndex(section(kRoutesByAirline), by_airline, new_routes.size(), 0) ||
+        !getMatrix(section(kAirportsByAirline), airports_by, airport_count) ||
+        !getMatrix(section(kAirlinesByAirport), airlines_by, airline_count)) {
+        return false;
+    }
+
+    SectionReader traffic_reader = section(kAirportTraffic);
+    std::vector<TrafficRanking::Entry> ranked;
+    TrafficRanking traffic;
+    if (!traffic_reader.getArray(ranked) || traffic_reader.remaining() ||
+        !traffic.assign(std::move(ranked))) {
+        return false;
+    }
+
+    SectionReader reach_reader = section(kReachability);
+    uint64_t reach_airports;
+    std::vector<uint64_t> bits;
+    ReachabilityIndex reach;
+    if (!reach_reader.get(reach_airports) || !reach_reader.getArray(bits) || reach_reader.remaining() ||
+        reach_airports > airport_count || !reach.assign(reach_airports, std::move(bits))) {
+        return false;
+    }
+
+    SectionReader search_reader = section(kAirportSearch);
+    std::vector<SearchDocRecord> doc_records;
+    std::vector<uint32_t> trigrams, posting_offsets, posting_codes;
+    if (!search_reader.getArray(doc_records) || !search_reader.getArray(trigrams) ||
+        !search_reader.getArray(posting_offsets) || !search_reader.getArray(posting_codes) ||
+        search_reader.remaining() || posting_offsets.size() != trigrams.size() + 1 ||
+        posting_offsets.front() != 0 || posting_offsets.back() != posting_codes.size() ||
+        !std::is_sorted(posting_offsets.begin(), posting_offsets.end())) {
+        return false;
+    }
+    std::vector<std::pair<IataCode, std::string>> docs;
+    docs.reserve(doc_records.size());
+    for (const SearchDocRecord& doc : doc_records) {
+        docs.emplace_back(IataCode::fromRaw(doc.code), str(doc.name));
+    }
+    TrigramIndex::Postings postings;
+    postings.reserve(trigrams.size());
+    for (size_t t = 0; t < trigrams.size(); ++t) {
+        auto first = posting_codes.begin() + posting_offsets[t];
+        auto last = posting_codes.begin() + posting_offsets[t + 1];
+        if (!postings.emplace(trigrams[t], std::vector<uint32_t>(first, last)).second) {
+            return false;
+        }
+    }
+    TrigramIndex search;
+    if (!ok || !search.assign(std::move(docs), std::move(postings))) {
+        return false;
+    }
+
+    airlines = std::move(new_airlines);
+    airports = std::move(new_airports);
+    routes = std::move(new_routes);
+    routes_by_source = std::move(by_source);
+    routes_by_dest = std::move(by_dest);
+    routes_by_airline = std::move(by_airline);
+    airports_by_airline = std::move(airports_by);
+    airlines_by_airport = std::move(airlines_by);
+    airport_traffic = std::move(traffic);
+    airport_geo = std::move(geo);
+    growAirportGeo();
+    reachability = std::move(reach);
+    airport_search = std::move(search);
+    
+    if (progress_) {
+        progress_->bytes_total.fetch_add(file.size(), std::memory_order_relaxed);
+        progress_->bytes_parsed.fetch_add(file.size(), std::memory_order_relaxed);
+        progress_->airlines.fetch_add(airlines.size(), std::memory_order_relaxed);
+        progress_->airports.fetch_add(airports.size(), std::memory_order_relaxed);
+        progress_->routes.fetch_add(routes.size(), std::memory_order_relaxed);
+    }
+    if (report_) {
+        // Rows were filtered when the snapshot was written, so none are rejected here
+        report_->source = "snapshot";
+        report_->airlines.accepted = airlines.size();
+        report_->airports.accepted = airports.size();
+        report_->routes.accepted = routes.size();
+        report_->addStep("snapshot load", std::chrono::steady_clock::now() - started);
+    }
+    return true;
+}
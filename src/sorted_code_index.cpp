@@ -0,0 +1,80 @@
+#include "../include/sorted_code_index.h"
+#include <algorithm>
+
+size_t SortedCodeIndex::lowerBound(IataCode code) const {
+    return static_cast<size_t>(
+        std::lower_bound(codes_.begin(), codes_.end(), code.raw()) - codes_.begin());
+}
+
+std::pair<size_t, size_t> SortedCodeIndex::prefixRange(std::string_view prefix) const {
+    if (prefix.size() > IataCode::kMaxLength) {
+        return std::make_pair(size_t(0), size_t(0));
+    }
+    // Codes are zero-padded big-endian, so every code with this prefix lies
+    // in [prefix, prefix + one step of the first free byte)
+    uint64_t low = IataCode(prefix).raw();
+    uint64_t high = low + (uint64_t(1) << (8 * (IataCode::kMaxLength - prefix.size())));
+    size_t first = lowerBound(IataCode::fromRaw(static_cast<uint32_t>(low)));
+    size_t last = high > UINT32_MAX ? codes_.size()
+                                    : lowerBound(IataCode::fromRaw(static_cast<uint32_t>(high)));
+    return std::make_pair(first, last);
+}
+
+void SortedCodeIndex::set(IataCode code, uint32_t row) {
+    merge();
+    size_t i = lowerBound(code);
+    if (i < codes_.size() && codes_[i] == code.raw()) {
+        rows_[i] = row;
+        return;
+    }
+    codes_.insert(codes_.begin() + i, code.raw());
+    rows_.insert(rows_.begin() + i, row);
+}
+
+void SortedCodeIndex::erase(IataCode code) {
+    merge();
+    size_t i = lowerBound(code);
+    if (i < codes_.size() && codes_[i] == code.raw()) {
+        codes_.erase(codes_.begin() + i);
+        rows_.erase(rows_.begin() + i);
+    }
+}
+
+void SortedCodeIndex::merge() {
+    if (pending_.empty()) {
+        return;
+    }
+    std::stable_sort(pending_.begin(), pending_.end(),
+        [](const std::pair<uint32_t, uint32_t>& a, const std::pair<uint32_t, uint32_t>& b) {
+            return a.first < b.first;
+        });
+
+    std::vector<uint32_t> codes;
+    std::vector<uint32_t> rows;
+    codes.reserve(codes_.size() + pending_.size());
+    rows.reserve(codes_.size() + pending_.size());
+    size_t i = 0;
+    size_t p = 0;
+    while (i < codes_.size() || p < pending_.size()) {
+        if (p == pending_.size() || (i < codes_.size() && codes_[i] < pending_[p].first)) {
+            codes.push_back(codes_[i]);
+            rows.push_back(rows_[i]);
+            ++i;
+            continue;
+        }
+        // Last staged entry for this code; it replaces any existing one
+        uint32_t code = pending_[p].first;
+        while (p + 1 < pending_.size() && pending_[p + 1].first == code) {
+            ++p;
+        }
+        codes.push_back(code);
+        rows.push_back(pending_[p].second);
+        ++p;
+        if (i < codes_.size() && codes_[i] == code) {
+            ++i;
+        }
+    }
+    codes_.swap(codes);
+    rows_.swap(rows);
+    pending_.clear();
+}
@@ -0,0 +1,68 @@
+#include "../include/traffic_ranking.h"
+#include <algorithm>
+
+void TrafficRanking::build(std::vector<Entry> entries) {
+    std::sort(entries.begin(), entries.end(), before);
+    entries_ = std::move(entries);
+    indexPositions();
+}
+
+bool TrafficRanking::assign(std::vector<Entry> ranked) {
+    for (size_t i = 1; i < ranked.size(); ++i) {
+        if (!before(ranked[i - 1], ranked[i])) {
+            return false;
+        }
+    }
+    entries_ = std::move(ranked);
+    indexPositions();
+    return true;
+}
+
+void TrafficRanking::set(const Entry& entry) {
+    IataCode code = IataCode::fromRaw(entry.code);
+    uint32_t found = positions_.find(code);
+    size_t i = found;
+    if (found == FlatCodeMap::kNone) {
+        i = entries_.size();
+        entries_.push_back(entry);
+        positions_.set(code, static_cast<uint32_t>(i));
+    } else {
+        entries_[i] = entry;
+    }
+
+    // Only this entry is out of place, so it bubbles one way or the other
+    while (i > 0 && before(entries_[i], entries_[i - 1])) {
+        swapEntries(i, i - 1);
+        --i;
+    }
+    while (i + 1 < entries_.size() && before(entries_[i + 1], entries_[i])) {
+        swapEntries(i, i + 1);
+        ++i;
+    }
+}
+
+void TrafficRanking::erase(IataCode code) {
+    uint32_t i = positions_.find(code);
+    if (i == FlatCodeMap::kNone) {
+        return;
+    }
+    positions_.erase(code);
+    entries_.erase(entries_.begin() + i);
+    for (size_t j = i; j < entries_.size(); ++j) {
+        positions_.set(IataCode::fromRaw(entries_[j].code), static_cast<uint32_t>(j));
+    }
+}
+
+void TrafficRanking::indexPositions() {
+    positions_.clear();
+    positions_.reserve(entries_.size());
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        positions_.set(IataCode::fromRaw(entries_[i].code), static_cast<uint32_t>(i));
+    }
+}
+
+void TrafficRanking::swapEntries(size_t i, size_t j) {
+    std::swap(entries_[i], entries_[j]);
+    positions_.set(IataCode::fromRaw(entries_[i].code), static_cast<uint32_t>(i));
+    positions_.set(IataCode::fromRaw(entries_[j].code), static_cast<uint32_t>(j));
+}
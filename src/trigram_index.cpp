@@ -0,0 +1,218 @@
+#include "../include/trigram_index.h"
+#include "../include/csr_index.h"
+#include <algorithm>
+
+namespace {
+
+std::string lowerAscii(std::string_view text) {
+    std::string lower(text);
+    for (char& c : lower) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return lower;
+}
+
+uint32_t trigramAt(std::string_view text, size_t i) {
+    return (static_cast<uint32_t>(static_cast<uint8_t>(text[i])) << 16) |
+           (static_cast<uint32_t>(static_cast<uint8_t>(text[i + 1])) << 8) |
+           static_cast<uint32_t>(static_cast<uint8_t>(text[i + 2]));
+}
+
+void appendTrigrams(std::string_view text, std::vector<uint32_t>& out) {
+    for (size_t i = 0; i + 3 <= text.size(); ++i) {
+        out.push_back(trigramAt(text, i));
+    }
+}
+
+void sortUnique(std::vector<uint32_t>& values) {
+    std::sort(values.begin(), values.end());
+    values.erase(std::unique(values.begin(), values.end()), values.end());
+}
+
+} // namespace
+
+void TrigramIndex::clear() {
+    docs_.clear();
+    doc_of_.clear();
+    postings_.clear();
+}
+
+void TrigramIndex::set(IataCode code, std::string_view name) {
+    erase(code);
+    add(code, name, true);
+}
+
+void TrigramIndex::erase(IataCode code) {
+    uint32_t slot = doc_of_.find(code);
+    if (slot == FlatCodeMap::kNone) {
+        return;
+    }
+    for (uint32_t trigram : trigrams(docs_[slot])) {
+        auto it = postings_.find(trigram);
+        std::vector<uint32_t>& codes = it->second;
+        auto at = std::lower_bound(codes.begin(), codes.end(), code.raw());
+        if (at != codes.end() && *at == code.raw()) {
+            codes.erase(at);
+        }
+        if (codes.empty()) {
+            postings_.erase(it);
+        }
+    }
+
+    // The last doc moves into the freed slot
+    doc_of_.erase(code);
+    if (slot + 1 != docs_.size()) {
+        docs_[slot] = std::move(docs_.back());
+        doc_of_.set(docs_[slot].code, slot);
+    }
+    docs_.pop_back();
+}
+
+void TrigramIndex::stage(IataCode code, std::string_view name) {
+    add(code, name, false);
+}
+
+void TrigramIndex::merge() {
+    for (auto& entry : postings_) {
+        std::sort(entry.second.begin(), entry.second.end());
+    }
+}
+
+bool TrigramIndex::assign(std::vector<std::pair<IataCode, std::string>> docs, Postings postings) {
+    std::vector<Doc> new_docs;
+    FlatCodeMap new_doc_of;
+    new_docs.reserve(docs.size());
+    new_doc_of.reserve(docs.size());
+    for (auto& doc : docs) {
+        if (new_doc_of.find(doc.first) != FlatCodeMap::kNone) {
+            return false;
+        }
+        new_doc_of.set(doc.first, static_cast<uint32_t>(new_docs.size()));
+        new_docs.push_back(Doc{doc.first, lowerAscii(doc.first.str()), std::move(doc.second)});
+    }
+    for (const auto& entry : postings) {
+        const std::vector<uint32_t>& codes = entry.second;
+        if (!std::is_sorted(codes.begin(), codes.end())) {
+            return false;
+        }
+        for (uint32_t code : codes) {
+            if (new_doc_of.find(IataCode::fromRaw(code)) == FlatCodeMap::kNone) {
+                return false;
+            }
+        }
+    }
+    docs_ = std::move(new_docs);
+    doc_of_ = std::move(new_doc_of);
+    postings_ = std::move(postings);
+    return true;
+}
+
+void TrigramIndex::add(IataCode code, std::string_view name, bool sorted) {
+    Doc doc{code, lowerAscii(code.str()), lowerAscii(name)};
+    for (uint32_t trigram : trigrams(doc)) {
+        std::vector<uint32_t>& codes = postings_[trigram];
+        if (sorted) {
+            codes.insert(std::lower_bound(codes.begin(), codes.end(), code.raw()), code.raw());
+        } else {
+            codes.push_back(code.raw());
+        }
+    }
+    doc_of_.set(code, static_cast<uint32_t>(docs_.size()));
+    docs_.push_back(std::move(doc));
+}
+
+std::vector<uint32_t> TrigramIndex::trigrams(const Doc& doc) {
+    std::vector<uint32_t> result;
+    appendTrigrams(doc.code_text, result);
+    appendTrigrams(doc.name, result);
+    sortUnique(result);
+    return result;
+}
+
+std::vector<IataCode> TrigramIndex::search(std::string_view query, size_t limit) const {
+    std::vector<IataCode> result;
+    std::string q = lowerAscii(query);
+    if (q.empty() || limit == 0) {
+        return result;
+    }
+
+    // Candidate slots: every doc for a short query, otherwise the docs in
+    // every posting list of the query's trigrams, smallest list first
+    std::vector<uint32_t> slots;
+    if (q.size() < 3) {
+        slots.resize(docs_.size());
+        for (size_t i = 0; i < slots.size(); ++i) {
+            slots[i] = static_cast<uint32_t>(i);
+        }
+    } else {
+        std::vector<uint32_t> wanted;
+        appendTrigrams(q, wanted);
+        sortUnique(wanted);
+        std::vector<const std::vector<uint32_t>*> lists;
+        for (uint32_t trigram : wanted) {
+            auto it = postings_.find(trigram);
+            if (it == postings_.end()) {
+                return result;
+            }
+            lists.push_back(&it->second);
+        }
+        std::sort(lists.begin(), lists.end(),
+                  [](const std::vector<uint32_t>* a, const std::vector<uint32_t>* b) {
+                      return a->size() < b->size();
+                  });
+        std::vector<uint32_t> codes = *lists.front();
+        for (size_t l = 1; l < lists.size() && !codes.empty(); ++l) {
+            const uint32_t* first = lists[l]->data();
+            const uint32_t* last = first + lists[l]->size();
+            size_t kept = 0;
+            for (uint32_t code : codes) {
+                first = gallopTo(first, last, code);
+                if (first == last) {
+                    break;
+                }
+                if (*first == code) {
+                    codes[kept++] = code;
+                }
+            }
+            codes.resize(kept);
+        }
+        for (uint32_t code : codes) {
+            slots.push_back(doc_of_.find(IataCode::fromRaw(code)));
+        }
+    }
+
+    // Lower ranks first: an exact code beats the rest, then a code prefix,
+    // then a name prefix, each rule only ordering ties of the ones before
+    std::vector<std::pair<int, uint32_t>> matches;
+    for (uint32_t slot : slots) {
+        const Doc& doc = docs_[slot];
+        bool code_prefix = doc.code_text.compare(0, q.size(), q) == 0;
+        bool name_prefix = doc.name.compare(0, q.size(), q) == 0;
+        if (!code_prefix && !name_prefix && doc.code_text.find(q) == std::string::npos &&
+            doc.name.find(q) == std::string::npos) {
+            continue;
+        }
+        int rank = (doc.code_text == q ? 0 : 4) + (code_prefix ? 0 : 2) + (name_prefix ? 0 : 1);
+        matches.emplace_back(rank, slot);
+    }
+
+    auto better = [this](const std::pair<int, uint32_t>& a, const std::pair<int, uint32_t>& b) {
+        if (a.first != b.first) {
+            return a.first < b.first;
+        }
+        const Doc& x = docs_[a.second];
+        const Doc& y = docs_[b.second];
+        if (x.code_text != y.code_text) {
+            return x.code_text < y.code_text;
+        }
+        return x.code.raw() < y.code.raw();
+    };
+    size_t kept = std::min(limit, matches.size());
+    std::partial_sort(matches.begin(), matches.begin() + kept, matches.end(), better);
+    for (size_t i = 0; i < kept; ++i) {
+        result.push_back(docs_[matches[i].second].code);
+    }
+    return result;
+}
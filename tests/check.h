@@ -0,0 +1,54 @@
+#ifndef TESTS_CHECK_H
+#define TESTS_CHECK_H
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Minimal assertions for the test executables. A failed CHECK prints where
+// and what, and the run carries on so one pass reports every failure; main
+// returns testResult().
+inline int& testFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(expr)                                                                  \
+    do {                                                                             \
+        if (!(expr)) {                                                               \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #expr ") failed\n"; \
+            ++testFailures();                                                        \
+        }                                                                            \
+    } while (0)
+
+inline int testResult() {
+    if (testFailures() > 0) {
+        std::cerr << testFailures() << " check(s) failed\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Tests get the source directory, which holds the bundled .dat files, as
+// their first argument
+inline std::string dataFile(int argc, char** argv, const std::string& name) {
+    return (argc > 1 ? std::string(argv[1]) : std::string(".")) + "/" + name;
+}
+
+inline std::vector<std::string> readLines(const std::string& path) {
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (!line.empty()) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+#endif
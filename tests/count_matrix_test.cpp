@@ -0,0 +1,178 @@
+// CountMatrix against counts tallied in std::maps, on the routes.dat
+// airline x airport counts, and its in-place increments and decrements
+// against a fresh build of the same occurrences.
+#include "check.h"
+#include "../include/count_matrix.h"
+#include "../include/csv_parser.h"
+#include "../include/route_table.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+
+namespace {
+
+// One (row, col) per occurrence
+using Occurrences = std::vector<std::pair<uint32_t, uint32_t>>;
+
+CountMatrix buildFrom(const Occurrences& occurrences, size_t row_count,
+                      const std::vector<uint32_t>& col_order) {
+    std::vector<std::vector<uint32_t>> cols(row_count);
+    for (const auto& occurrence : occurrences) {
+        cols[occurrence.first].push_back(occurrence.second);
+    }
+    CountMatrix matrix;
+    matrix.build(row_count, col_order, [&](uint32_t r, auto add) {
+        for (uint32_t col : cols[r]) {
+            add(col);
+        }
+    });
+    return matrix;
+}
+
+// Every row holds its nonzero counts, highest first, ties by col_order
+void checkAgainst(const CountMatrix& matrix, const Occurrences& occurrences,
+                  size_t row_count, const std::vector<uint32_t>& col_order) {
+    std::vector<std::map<uint32_t, uint32_t>> counts(row_count);
+    for (const auto& occurrence : occurrences) {
+        ++counts[occurrence.first][occurrence.second];
+    }
+    for (uint32_t r = 0; r < row_count; ++r) {
+        std::vector<CountCell> expected;
+        for (const auto& entry : counts[r]) {
+            expected.push_back(CountCell{entry.first, entry.second});
+        }
+        std::sort(expected.begin(), expected.end(), [&](const CountCell& a, const CountCell& b) {
+            if (a.count != b.count) {
+                return a.count > b.count;
+            }
+            return col_order[a.col] < col_order[b.col];
+        });
+        CellSpan row = matrix.row(r);
+        CHECK(row.size() == expected.size());
+        for (size_t i = 0; i < row.size() && i < expected.size(); ++i) {
+            CHECK(row[i].col == expected[i].col);
+            CHECK(row[i].count == expected[i].count);
+        }
+    }
+}
+
+bool sameMatrix(const CountMatrix& a, const CountMatrix& b, size_t row_count) {
+    for (uint32_t r = 0; r < row_count; ++r) {
+        CellSpan x = a.row(r);
+        CellSpan y = b.row(r);
+        if (x.size() != y.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < x.size(); ++i) {
+            if (x[i].col != y[i].col || x[i].count != y[i].count) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Empty matrix, unbuilt and built without rows
+    CountMatrix empty;
+    CHECK(empty.rowCount() == 0);
+    CHECK(empty.row(0).empty());
+    empty.decrement(0, 0);
+    CHECK(empty.rowCount() == 0);
+    empty.build(4, std::vector<uint32_t>(), [](uint32_t, auto) {});
+    CHECK(empty.rowCount() == 4);
+    CHECK(empty.row(3).empty());
+    // Increments into an unbuilt matrix grow it
+    CountMatrix grown;
+    grown.increment(2, 5, 9);
+    grown.increment(2, 1, 3);
+    grown.increment(2, 5, 9);
+    CHECK(grown.rowCount() == 3);
+    CHECK(grown.row(0).empty());
+    CHECK(grown.row(2).size() == 2);
+    CHECK(grown.row(2)[0].col == 5 && grown.row(2)[0].count == 2);
+    grown.decrement(2, 5);
+    grown.decrement(2, 5);
+    CHECK(grown.row(2).size() == 1);
+    CHECK(grown.row(2)[0].col == 1);
+
+    // Airline x airport route counts from routes.dat, as Database counts
+    // them: a route counts once at each end
+    RouteTable routes;
+    for (const std::string& line : readLines(dataFile(argc, argv, "routes.dat"))) {
+        Route route = CSVParser::parseRoute(line);
+        IataCode code;
+        if (IataCode::parse(route.airline_iata, code) && IataCode::parse(route.source_iata, code) &&
+            IataCode::parse(route.dest_iata, code)) {
+            routes.append(route);
+        }
+    }
+    CHECK(routes.size() > 60000);
+    size_t airlines = routes.airlineCodes().size();
+    size_t airports = routes.airportCodes().size();
+    // Columns are airports, ordered by code; a few spare columns past the
+    // loaded ones take the new airports below
+    std::vector<uint32_t> col_order(airports + 20);
+    for (size_t col = 0; col < col_order.size(); ++col) {
+        col_order[col] = col < airports ? routes.airportCodes().at(static_cast<uint32_t>(col)).raw()
+                                        : UINT32_MAX - static_cast<uint32_t>(col);
+    }
+    std::vector<uint32_t> loaded_order(col_order.begin(), col_order.begin() + airports);
+    Occurrences occurrences;
+    for (size_t r = 0; r < routes.size(); ++r) {
+        occurrences.emplace_back(routes.airline(r), routes.source(r));
+        occurrences.emplace_back(routes.airline(r), routes.dest(r));
+    }
+    CountMatrix matrix = buildFrom(occurrences, airlines, loaded_order);
+    CHECK(matrix.rowCount() == airlines);
+    checkAgainst(matrix, occurrences, airlines, col_order);
+
+    // Increments and decrements in place, including new rows and columns
+    // and cells that drop to zero, match a rebuild after every batch
+    size_t rows = airlines + 5;
+    std::mt19937 rng(18);
+    for (int step = 0; step < 3000; ++step) {
+        if (rng() % 2 == 0 && !occurrences.empty()) {
+            size_t i = rng() % occurrences.size();
+            matrix.decrement(occurrences[i].first, occurrences[i].second);
+            occurrences[i] = occurrences.back();
+            occurrences.pop_back();
+        } else {
+            uint32_t r = rng() % rows;
+            // Mostly columns the row already has, so counts climb and
+            // reorder as well as appear
+            CellSpan existing = r < matrix.rowCount() ? matrix.row(r) : CellSpan();
+            uint32_t col = !existing.empty() && rng() % 2 ? existing[rng() % existing.size()].col
+                                                          : rng() % col_order.size();
+            matrix.increment(r, col, col_order[col]);
+            occurrences.emplace_back(r, col);
+        }
+        if (step % 300 == 0 || step == 2999) {
+            CountMatrix fresh = buildFrom(occurrences, rows, col_order);
+            CHECK(sameMatrix(matrix, fresh, rows));
+        }
+    }
+    checkAgainst(matrix, occurrences, matrix.rowCount(), col_order);
+
+    // A row emptied by decrements reads as empty
+    uint32_t busiest = 0;
+    for (uint32_t r = 0; r < matrix.rowCount(); ++r) {
+        if (matrix.row(r).size() > matrix.row(busiest).size()) {
+            busiest = r;
+        }
+    }
+    while (!matrix.row(busiest).empty()) {
+        matrix.decrement(busiest, matrix.row(busiest)[0].col);
+    }
+    CHECK(matrix.row(busiest).empty());
+    // Decrementing a missing cell changes nothing
+    CountMatrix before = matrix;
+    matrix.decrement(busiest, 0);
+    matrix.decrement(static_cast<uint32_t>(matrix.rowCount()) + 1, 0);
+    CHECK(sameMatrix(before, matrix, matrix.rowCount()));
+
+    return testResult();
+}
@@ -0,0 +1,183 @@
+// CsrIndex against per-key sorted vectors, on the routes.dat columns, and
+// its in-place writes against a fresh build of the written columns.
+#include "check.h"
+#include "../include/csr_index.h"
+#include "../include/csv_parser.h"
+#include "../include/route_table.h"
+#include <algorithm>
+#include <random>
+#include <utility>
+
+namespace {
+
+// Key -> (neighbor, row) pairs in index order: by row alone without
+// neighbors, by (neighbor, row) with them
+std::vector<std::vector<std::pair<uint32_t, uint32_t>>> naiveIndex(
+    const std::vector<uint32_t>& keys, size_t key_count, const std::vector<uint32_t>* neighbors) {
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> runs(key_count);
+    for (size_t row = 0; row < keys.size(); ++row) {
+        runs[keys[row]].emplace_back(neighbors ? (*neighbors)[row] : 0, static_cast<uint32_t>(row));
+    }
+    for (auto& run : runs) {
+        std::sort(run.begin(), run.end());
+    }
+    return runs;
+}
+
+void checkAgainst(const CsrIndex& index, const std::vector<uint32_t>& keys, size_t key_count,
+                  const std::vector<uint32_t>* neighbors) {
+    auto runs = naiveIndex(keys, key_count, neighbors);
+    for (uint32_t key = 0; key < key_count; ++key) {
+        IdSpan rows = index.rows(key);
+        IdSpan adjacent = index.neighbors(key);
+        CHECK(rows.size() == runs[key].size());
+        CHECK(adjacent.size() == (neighbors ? runs[key].size() : 0));
+        for (size_t i = 0; i < rows.size() && i < runs[key].size(); ++i) {
+            CHECK(rows[i] == runs[key][i].second);
+            if (neighbors && i < adjacent.size()) {
+                CHECK(adjacent[i] == runs[key][i].first);
+            }
+        }
+    }
+    // Keys past the index read as empty
+    CHECK(index.rows(static_cast<uint32_t>(key_count) + 5).empty());
+}
+
+bool sameIndex(const CsrIndex& a, const CsrIndex& b, size_t key_count) {
+    for (uint32_t key = 0; key < key_count; ++key) {
+        IdSpan x = a.rows(key);
+        IdSpan y = b.rows(key);
+        IdSpan p = a.neighbors(key);
+        IdSpan q = b.neighbors(key);
+        if (!std::equal(x.begin(), x.end(), y.begin(), y.end()) ||
+            !std::equal(p.begin(), p.end(), q.begin(), q.end())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+RouteTable loadRoutes(const std::string& path) {
+    RouteTable routes;
+    for (const std::string& line : readLines(path)) {
+        Route route = CSVParser::parseRoute(line);
+        IataCode code;
+        if (IataCode::parse(route.airline_iata, code) && IataCode::parse(route.source_iata, code) &&
+            IataCode::parse(route.dest_iata, code)) {
+            routes.append(route);
+        }
+    }
+    return routes;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Empty index, unbuilt and built from no rows
+    CsrIndex empty;
+    CHECK(empty.keyCount() == 0);
+    CHECK(empty.rows(0).empty());
+    CHECK(empty.neighbors(0).empty());
+    empty.build(std::vector<uint32_t>(), 3, std::vector<uint32_t>());
+    CHECK(empty.keyCount() == 3);
+    CHECK(empty.rows(2).empty());
+    empty.erase(1, 0, 0);
+    empty.eraseRows({0});
+    CHECK(empty.rows(1).empty());
+
+    // Built from routes.dat, as Database builds its three route indexes
+    RouteTable routes = loadRoutes(dataFile(argc, argv, "routes.dat"));
+    CHECK(routes.size() > 60000);
+    size_t airports = routes.airportCodes().size();
+    size_t airlines = routes.airlineCodes().size();
+    std::vector<uint32_t> sources = routes.sourceColumn();
+    std::vector<uint32_t> dests = routes.destColumn();
+    std::vector<uint32_t> carriers = routes.airlineColumn();
+
+    CsrIndex by_source;
+    CsrIndex by_airline;
+    by_source.build(sources, airports, dests);
+    by_airline.build(carriers, airlines);
+    CHECK(by_source.keyCount() == airports);
+    checkAgainst(by_source, sources, airports, &dests);
+    checkAgainst(by_airline, carriers, airlines, nullptr);
+
+    // Route writes as Database makes them: appended rows, rows re-filed
+    // under a new key or neighbor, and batches of rows erased with the
+    // rest renumbered. New keys and neighbors past the built ones appear
+    // along the way.
+    std::mt19937 rng(18);
+    for (int step = 0; step < 600; ++step) {
+        int op = static_cast<int>(rng() % 10);
+        if (op < 4) {
+            uint32_t row = static_cast<uint32_t>(sources.size());
+            uint32_t source = rng() % (airports + 20);
+            uint32_t dest = rng() % 8 == 0 ? source : rng() % (airports + 20);
+            uint32_t carrier = rng() % (airlines + 5);
+            sources.push_back(source);
+            dests.push_back(dest);
+            carriers.push_back(carrier);
+            by_source.insert(source, row, dest);
+            by_airline.insert(carrier, row);
+        } else if (op < 7) {
+            uint32_t row = rng() % sources.size();
+            by_source.erase(sources[row], row, dests[row]);
+            by_airline.erase(carriers[row], row);
+            if (rng() % 2) {
+                sources[row] = rng() % airports;
+            } else {
+                dests[row] = rng() % airports;
+            }
+            carriers[row] = rng() % airlines;
+            by_source.insert(sources[row], row, dests[row]);
+            by_airline.insert(carriers[row], row);
+        } else {
+            std::vector<uint32_t> erased;
+            size_t count = op == 9 ? 1 + rng() % 200 : 1;
+            for (size_t i = 0; i < count; ++i) {
+                erased.push_back(rng() % sources.size());
+            }
+            std::sort(erased.begin(), erased.end());
+            erased.erase(std::unique(erased.begin(), erased.end()), erased.end());
+            for (auto it = erased.rbegin(); it != erased.rend(); ++it) {
+                sources.erase(sources.begin() + *it);
+                dests.erase(dests.begin() + *it);
+                carriers.erase(carriers.begin() + *it);
+            }
+            by_source.eraseRows(erased);
+            by_airline.eraseRows(erased);
+        }
+
+        if (step % 50 == 0 || step == 599) {
+            size_t source_keys = std::max(by_source.keyCount(), airports);
+            size_t carrier_keys = std::max(by_airline.keyCount(), airlines);
+            CsrIndex fresh_source;
+            CsrIndex fresh_airline;
+            fresh_source.build(sources, source_keys, dests);
+            fresh_airline.build(carriers, carrier_keys);
+            CHECK(sameIndex(by_source, fresh_source, source_keys));
+            CHECK(sameIndex(by_airline, fresh_airline, carrier_keys));
+        }
+    }
+    checkAgainst(by_source, sources, by_source.keyCount(), &dests);
+    checkAgainst(by_airline, carriers, by_airline.keyCount(), nullptr);
+
+    // Erasing a row that is not filed there changes nothing
+    CsrIndex before = by_airline;
+    by_airline.erase(carriers[0], static_cast<uint32_t>(sources.size()) + 1);
+    by_airline.erase(static_cast<uint32_t>(by_airline.keyCount()) + 3, 0);
+    CHECK(sameIndex(before, by_airline, by_airline.keyCount()));
+
+    // Erasing every row
+    std::vector<uint32_t> all(sources.size());
+    for (size_t row = 0; row < all.size(); ++row) {
+        all[row] = static_cast<uint32_t>(row);
+    }
+    by_source.eraseRows(all);
+    for (uint32_t key = 0; key < by_source.keyCount(); ++key) {
+        CHECK(by_source.rows(key).empty());
+        CHECK(by_source.neighbors(key).empty());
+    }
+
+    return testResult();
+}
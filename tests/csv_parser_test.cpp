@@ -0,0 +1,128 @@
+// CSVParser::parseLine against the character-at-a-time splitter it
+// replaced, on every line of the bundled .dat files and on quote-heavy
+// lines built to put quotes and commas on either side of the 16-, 32- and
+// 64-byte block edges. The structural kernel is picked once per process,
+// so ctest runs this once per AIRTRAVEL_CSV_KERNEL value.
+#include "check.h"
+#include "../include/csv_parser.h"
+#include <cstdlib>
+#include <random>
+#include <string>
+
+namespace {
+
+// The splitter before the SIMD rewrite
+std::vector<std::string> naiveSplit(const std::string& line) {
+    std::vector<std::string> fields;
+    std::string field;
+    bool inQuotes = false;
+    for (size_t i = 0; i < line.length(); ++i) {
+        char c = line[i];
+        if (c == '"') {
+            if (inQuotes && i + 1 < line.length() && line[i + 1] == '"') {
+                field += '"';
+                ++i;
+            } else {
+                inQuotes = !inQuotes;
+            }
+        } else if (c == ',' && !inQuotes) {
+            fields.push_back(field);
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields.push_back(field);
+    return fields;
+}
+
+// Both parseLine overloads split line as the naive splitter does. The
+// buffer is shared across calls, as the loaders share it across rows.
+bool splitsLikeNaive(const std::string& line, CSVParser::FieldBuffer& buffer) {
+    std::vector<std::string> expected = naiveSplit(line);
+    const std::vector<std::string_view>& views = CSVParser::parseLine(std::string_view(line), buffer);
+    bool same = std::vector<std::string>(views.begin(), views.end()) == expected &&
+                CSVParser::parseLine(line) == expected;
+    if (!same) {
+        std::cerr << "split differs: " << line << "\n";
+    }
+    return same;
+}
+
+// Lines whose quotes, escaped quotes and commas land on every position
+// around the block edges
+std::vector<std::string> edgeLines() {
+    std::vector<std::string> lines = {
+        "",
+        ",",
+        "a,b,",
+        "\"a\",",
+        ",,,",
+        "\"\"",
+        "\"\"\"\"",
+        "a,\"b\"\"c\",d",
+        "\"\"\"\",x",
+        "\"a\"\"\"\"b\"",
+        "a,\"b,c\",d",
+        "a,b\r",
+        "a,\"b\r\"",
+        "1,\"Name, with comma\",\\N,\"\",\r",
+        "a,\"bc",
+        "\"abc,def",
+        "a,\"b\"\"",
+        "a,b\"c\"d,e",
+        "\"a\"b,c",
+    };
+    const std::vector<std::string> patterns = {
+        "\"q\"\"u,o\"",
+        "\"\"\"\"",
+        "\",\"",
+        "x,\"y\"",
+        "\"a,b",
+        "\"\",",
+        ",\r",
+    };
+    for (const std::string& pattern : patterns) {
+        for (size_t prefix = 0; prefix <= 130; ++prefix) {
+            std::string line = std::string(prefix, 'x') + pattern;
+            lines.push_back(line);
+            lines.push_back(line + ",tail");
+            lines.push_back(line + std::string(70, 'y') + pattern);
+        }
+    }
+    return lines;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* kernel = std::getenv("AIRTRAVEL_CSV_KERNEL");
+    std::cout << "AIRTRAVEL_CSV_KERNEL=" << (kernel ? kernel : "(unset)") << "\n";
+
+    CSVParser::FieldBuffer buffer;
+    size_t lines = 0;
+    for (const char* name : {"airlines.dat", "airports.dat", "routes.dat"}) {
+        for (const std::string& line : readLines(dataFile(argc, argv, name))) {
+            CHECK(splitsLikeNaive(line, buffer));
+            ++lines;
+        }
+    }
+    CHECK(lines > 70000);
+
+    for (const std::string& line : edgeLines()) {
+        CHECK(splitsLikeNaive(line, buffer));
+    }
+
+    // Random lines over the structural characters and a few others
+    std::mt19937 rng(3);
+    const char alphabet[] = {'a', 'b', ',', '"', '"', ' ', '\r', '\\', 'N'};
+    for (int n = 0; n < 20000; ++n) {
+        std::string line(rng() % 200, ' ');
+        for (char& c : line) {
+            c = alphabet[rng() % sizeof(alphabet)];
+        }
+        CHECK(splitsLikeNaive(line, buffer));
+    }
+
+    return testResult();
+}
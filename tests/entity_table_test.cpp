@@ -0,0 +1,165 @@
+// EntityTable against the maps it replaced: an unordered_map by IATA code,
+// one by id and a std::map for code order, fed the same airlines.dat rows
+// and the same writes.
+#include "check.h"
+#include "../include/csv_parser.h"
+#include "../include/entity_table.h"
+#include <map>
+#include <random>
+#include <unordered_map>
+
+namespace {
+
+bool sameAirline(const Airline& a, const Airline& b) {
+    return a.id == b.id && a.name == b.name && a.alias == b.alias && a.iata == b.iata &&
+           a.icao == b.icao && a.callsign == b.callsign && a.country == b.country &&
+           a.active == b.active;
+}
+
+bool sameView(const AirlineView& view, const Airline& airline) {
+    return view.id == airline.id && view.name == airline.name && view.iata == airline.iata &&
+           view.country == airline.country && view.active == airline.active;
+}
+
+struct Baseline {
+    std::unordered_map<std::string, Airline> by_iata;
+    std::unordered_map<int, Airline> by_id;
+    std::map<std::string, int> sorted;  // code -> id
+};
+
+// Every code and id resolves to the same airline, and code order matches
+void checkAgainst(const EntityTable<Airline>& table, const Baseline& baseline) {
+    CHECK(table.size() == baseline.by_id.size());
+    CHECK(table.sorted().size() == baseline.sorted.size());
+    for (const auto& entry : baseline.by_iata) {
+        uint32_t row = table.find(IataCode(entry.first));
+        CHECK(row != EntityTable<Airline>::kNone);
+        if (row != EntityTable<Airline>::kNone) {
+            CHECK(sameAirline(table.get(row), entry.second));
+            CHECK(sameView(table.view(row), entry.second));
+        }
+    }
+    for (const auto& entry : baseline.by_id) {
+        uint32_t row = table.findId(entry.first);
+        CHECK(row != EntityTable<Airline>::kNone);
+        if (row != EntityTable<Airline>::kNone) {
+            CHECK(sameAirline(table.get(row), entry.second));
+        }
+    }
+    auto expected = baseline.sorted.begin();
+    for (const AirlineView& view : table.sortedViews()) {
+        if (expected == baseline.sorted.end()) {
+            CHECK(false);
+            break;
+        }
+        CHECK(view.iata == expected->first);
+        CHECK(view.id == expected->second);
+        ++expected;
+    }
+}
+
+std::vector<Airline> loadAirlines(const std::string& path) {
+    std::vector<Airline> airlines;
+    for (const std::string& line : readLines(path)) {
+        Airline airline = CSVParser::parseAirline(line);
+        IataCode code;
+        if (airline.id > 0 && !airline.iata.empty() && airline.iata != "\\N" &&
+            IataCode::parse(airline.iata, code)) {
+            airlines.push_back(airline);
+        }
+    }
+    return airlines;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<Airline> airlines = loadAirlines(dataFile(argc, argv, "airlines.dat"));
+    CHECK(airlines.size() > 1000);
+
+    // Empty table
+    EntityTable<Airline> empty;
+    CHECK(empty.size() == 0);
+    CHECK(empty.find(IataCode("AA")) == EntityTable<Airline>::kNone);
+    CHECK(empty.findId(1) == EntityTable<Airline>::kNone);
+    CHECK(empty.sortedViews().empty());
+
+    // Bulk load through stage()/commit() and single inserts agree with the
+    // baseline, duplicate codes included (the last row wins the code)
+    EntityTable<Airline> staged;
+    EntityTable<Airline> inserted;
+    Baseline baseline;
+    for (const Airline& airline : airlines) {
+        staged.stage(IataCode(airline.iata), airline);
+        inserted.insert(IataCode(airline.iata), airline);
+        baseline.by_iata[airline.iata] = airline;
+        baseline.by_id[airline.id] = airline;
+        baseline.sorted[airline.iata] = airline.id;
+    }
+    staged.commit();
+    checkAgainst(staged, baseline);
+    checkAgainst(inserted, baseline);
+
+    // Updates in place, then deletes of random rows (the last row moves
+    // into each freed slot)
+    std::mt19937 rng(13);
+    for (int i = 0; i < 500; ++i) {
+        const Airline& pick = airlines[rng() % airlines.size()];
+        uint32_t row = staged.find(IataCode(pick.iata));
+        Airline updated = staged.get(row);
+        updated.name = "Renamed " + std::to_string(i);
+        updated.country = i % 2 ? "" : "Somewhere";
+        staged.set(row, updated);
+        baseline.by_iata[updated.iata] = updated;
+        baseline.by_id[updated.id] = updated;
+    }
+    checkAgainst(staged, baseline);
+
+    for (int i = 0; i < 600; ++i) {
+        const Airline& pick = airlines[rng() % airlines.size()];
+        uint32_t row = staged.find(IataCode(pick.iata));
+        if (row == EntityTable<Airline>::kNone) {
+            continue;
+        }
+        Airline erased = staged.get(row);
+        staged.erase(row);
+        baseline.by_iata.erase(erased.iata);
+        baseline.by_id.erase(erased.id);
+        baseline.sorted.erase(erased.iata);
+    }
+    // Rows that lost their code to a duplicate stay reachable by id only
+    for (auto it = baseline.by_id.begin(); it != baseline.by_id.end();) {
+        auto code = baseline.by_iata.find(it->second.iata);
+        if (code == baseline.by_iata.end() || code->second.id != it->first) {
+            uint32_t row = staged.findId(it->first);
+            CHECK(row != EntityTable<Airline>::kNone);
+            if (row != EntityTable<Airline>::kNone) {
+                staged.erase(row);
+            }
+            it = baseline.by_id.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    checkAgainst(staged, baseline);
+
+    // Deleting everything leaves an empty table that works again
+    while (staged.size() > 0) {
+        staged.erase(static_cast<uint32_t>(staged.size() - 1));
+    }
+    CHECK(staged.sortedViews().empty());
+    CHECK(staged.find(IataCode(airlines[0].iata)) == EntityTable<Airline>::kNone);
+    staged.insert(IataCode(airlines[0].iata), airlines[0]);
+    CHECK(staged.find(IataCode(airlines[0].iata)) == 0);
+
+    // Repeated updates of one row keep the arena bounded
+    Airline churn = airlines[0];
+    for (int i = 0; i < 10000; ++i) {
+        churn.name = std::string(100, static_cast<char>('a' + i % 26));
+        staged.set(0, churn);
+    }
+    CHECK(staged.arena().size() < 4096);
+    CHECK(staged.get(0).name == churn.name);
+
+    return testResult();
+}
@@ -0,0 +1,112 @@
+// FlatCodeMap against std::unordered_map under the same inserts,
+// overwrites and erases, on synthetic codes and the airports.dat codes.
+#include "check.h"
+#include "../include/csv_parser.h"
+#include "../include/flat_code_map.h"
+#include <random>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+using Baseline = std::unordered_map<uint32_t, uint32_t>;
+
+void checkAgainst(const FlatCodeMap& map, const Baseline& baseline,
+                  const std::vector<IataCode>& universe) {
+    CHECK(map.size() == baseline.size());
+    CHECK(map.empty() == baseline.empty());
+    for (IataCode code : universe) {
+        auto it = baseline.find(code.raw());
+        uint32_t expected = it == baseline.end() ? FlatCodeMap::kNone : it->second;
+        CHECK(map.find(code) == expected);
+    }
+}
+
+// Every code of one to three letters A..Z
+std::vector<IataCode> syntheticCodes() {
+    std::vector<IataCode> codes;
+    std::string code;
+    for (char a = 'A'; a <= 'Z'; ++a) {
+        codes.push_back(IataCode(std::string(1, a)));
+        for (char b = 'A'; b <= 'Z'; ++b) {
+            codes.push_back(IataCode(std::string{a, b}));
+            for (char c = 'A'; c <= 'Z'; ++c) {
+                codes.push_back(IataCode(std::string{a, b, c}));
+            }
+        }
+    }
+    return codes;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<IataCode> universe = syntheticCodes();
+
+    // Empty map, before and after clear()
+    FlatCodeMap map;
+    Baseline baseline;
+    checkAgainst(map, baseline, {universe.begin(), universe.begin() + 1000});
+    CHECK(!map.erase(IataCode("JFK")));
+    map.set(IataCode("JFK"), 7);
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.find(IataCode("JFK")) == FlatCodeMap::kNone);
+
+    // Set, overwrite and erase at random over ~18k codes, so the table
+    // grows, fills with tombstones and rehashes along the way
+    std::mt19937 rng(15);
+    for (int i = 0; i < 200000; ++i) {
+        IataCode code = universe[rng() % universe.size()];
+        uint32_t value = rng() % 1000000;
+        if (rng() % 3 == 0) {
+            bool present = baseline.erase(code.raw()) > 0;
+            CHECK(map.erase(code) == present);
+        } else {
+            map.set(code, value);
+            baseline[code.raw()] = value;
+        }
+        if (i % 20000 == 0) {
+            checkAgainst(map, baseline, universe);
+        }
+    }
+    checkAgainst(map, baseline, universe);
+
+    // Erasing everything, then reinserting into the same slots
+    for (IataCode code : universe) {
+        bool present = baseline.erase(code.raw()) > 0;
+        CHECK(map.erase(code) == present);
+    }
+    checkAgainst(map, baseline, universe);
+    for (size_t i = 0; i < universe.size(); i += 7) {
+        map.set(universe[i], static_cast<uint32_t>(i));
+        baseline[universe[i].raw()] = static_cast<uint32_t>(i);
+    }
+    checkAgainst(map, baseline, universe);
+
+    // The airports.dat codes, mapped to their row as Database does; a
+    // reserve()d map takes the same codes without changing answers
+    std::vector<IataCode> airport_codes;
+    for (const std::string& line : readLines(dataFile(argc, argv, "airports.dat"))) {
+        Airport airport = CSVParser::parseAirport(line);
+        IataCode code;
+        if (IataCode::parse(airport.iata, code)) {
+            airport_codes.push_back(code);
+        }
+    }
+    CHECK(airport_codes.size() > 5000);
+    FlatCodeMap airports;
+    FlatCodeMap reserved;
+    reserved.reserve(airport_codes.size());
+    Baseline airport_baseline;
+    for (size_t row = 0; row < airport_codes.size(); ++row) {
+        airports.set(airport_codes[row], static_cast<uint32_t>(row));
+        reserved.set(airport_codes[row], static_cast<uint32_t>(row));
+        airport_baseline[airport_codes[row].raw()] = static_cast<uint32_t>(row);
+    }
+    airport_codes.insert(airport_codes.end(), universe.begin(), universe.end());
+    checkAgainst(airports, airport_baseline, airport_codes);
+    checkAgainst(reserved, airport_baseline, airport_codes);
+
+    return testResult();
+}
@@ -0,0 +1,93 @@
+// GeoColumns against haversineMiles() for every pair of bundled airports,
+// from stored positions and from positions given by latitude/longitude, and
+// for tables short enough to run only the scalar tail of each batch. The
+// kernel is the SSE2 one unless the build enables AVX (-mavx), so the run
+// prints which.
+#include "check.h"
+#include "../include/csv_parser.h"
+#include "../include/geo_columns.h"
+#include "../include/great_circle.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// The bound geo_columns.h states: nearly antipodal pairs differ by up to
+// about 8e-6 miles (geo_columns_bench, SF and its antipode), every other
+// pair by about 1e-8. The bundled airports stay within 1e-8.
+const double kToleranceMiles = 1e-5;
+
+// Largest |milesFrom - haversineMiles| from source to positions first and on
+double maxError(const std::vector<double>& miles, const std::vector<GeoPoint>& points,
+                const GeoPoint& source, size_t first = 0) {
+    double worst = 0.0;
+    for (size_t j = first; j < points.size(); ++j) {
+        worst = std::max(worst, std::fabs(miles[j] - haversineMiles(source, points[j])));
+    }
+    return worst;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+#if defined(__AVX__)
+    std::cout << "kernel: avx\n";
+#elif defined(__SSE2__)
+    std::cout << "kernel: sse2\n";
+#else
+    std::cout << "kernel: scalar\n";
+#endif
+
+    std::vector<double> lat;
+    std::vector<double> lon;
+    for (const std::string& line : readLines(dataFile(argc, argv, "airports.dat"))) {
+        Airport airport = CSVParser::parseAirport(line);
+        lat.push_back(airport.latitude);
+        lon.push_back(airport.longitude);
+    }
+    size_t n = lat.size();
+    CHECK(n > 7000);
+
+    std::vector<GeoPoint> points(n);
+    for (size_t i = 0; i < n; ++i) {
+        points[i] = geoPoint(lat[i], lon[i]);
+    }
+    GeoColumns columns;
+    columns.assign(lat.data(), lon.data(), n);
+    CHECK(columns.size() == n);
+
+    // The kernel squares coordinate differences, so i to j and j to i give
+    // the same bits and each pair is checked once
+    std::vector<double> miles(n);
+    double worst = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        columns.milesFrom(i, miles.data());
+        worst = std::max(worst, maxError(miles, points, points[i], i));
+    }
+    std::cout << "max error over " << n * (n + 1) / 2 << " pairs: " << worst << " miles\n";
+    CHECK(worst <= kToleranceMiles);
+
+    // From positions that are not in the table, including the poles and
+    // both sides of the antimeridian
+    const double sources[][2] = {{90.0, 0.0}, {-90.0, 180.0}, {0.0, -180.0}, {0.0, 180.0},
+                                 {37.6188, -122.375}, {-37.6188, 57.625}};
+    for (const auto& source : sources) {
+        columns.milesFrom(source[0], source[1], miles.data());
+        CHECK(maxError(miles, points, geoPoint(source[0], source[1])) <= kToleranceMiles);
+    }
+
+    // Fewer positions than one batch, or a batch and a remainder
+    for (size_t count = 0; count <= 9; ++count) {
+        GeoColumns small;
+        small.assign(lat.data(), lon.data(), count);
+        CHECK(small.size() == count);
+        std::vector<GeoPoint> small_points(points.begin(), points.begin() + count);
+        std::vector<double> small_miles(count);
+        for (size_t i = 0; i < count; ++i) {
+            small.milesFrom(i, small_miles.data());
+            CHECK(maxError(small_miles, small_points, points[i]) <= kToleranceMiles);
+        }
+    }
+
+    return testResult();
+}
@@ -0,0 +1,330 @@
+// ItinerarySearch against every simple path, enumerated depth first, on
+// small hand-made networks and on the routes.dat network; plus the case a
+// per-airport cap got wrong and the truncation flag.
+#include "check.h"
+#include "../include/csv_parser.h"
+#include "../include/itinerary_search.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+
+namespace {
+
+// Everything an ItinerarySearch reads, built the way Database builds it.
+// Airports without a position are unusable.
+struct Network {
+    RouteTable routes;
+    CsrIndex routes_by_source;
+    std::vector<GeoPoint> positions;
+    std::vector<bool> usable;
+    ReachabilityIndex reachability;
+
+    Network(const std::vector<Route>& route_list,
+            const std::map<std::string, std::pair<double, double>>& airports) {
+        for (const Route& route : route_list) {
+            routes.append(route);
+        }
+        size_t count = routes.airportCodes().size();
+        for (uint32_t a = 0; a < count; ++a) {
+            auto it = airports.find(routes.airportCodes().at(a).str());
+            positions.push_back(it == airports.end() ? GeoPoint()
+                                                     : geoPoint(it->second.first, it->second.second));
+            usable.push_back(it != airports.end());
+        }
+        for (size_t r = 0; r < routes.size(); ++r) {
+            routes.setMiles(r, haversineMiles(positions[routes.source(r)], positions[routes.dest(r)]));
+        }
+        routes_by_source.build(routes.sourceColumn(), count, routes.destColumn());
+        reachability.build(routes_by_source, count, isUsable());
+    }
+
+    std::function<bool(uint32_t)> isUsable() const {
+        return [this](uint32_t a) { return usable[a]; };
+    }
+
+    ItineraryResult find(const std::string& source, const std::string& dest,
+                         const ItineraryQuery& query) const {
+        ItinerarySearch search(routes, routes_by_source, positions, reachability, isUsable());
+        return search.find(IataCode(source), IataCode(dest), query);
+    }
+};
+
+Route route(const std::string& airline, const std::string& source, const std::string& dest) {
+    Route r;
+    r.airline_iata = airline;
+    r.source_iata = source;
+    r.dest_iata = dest;
+    return r;
+}
+
+std::string path(const Itinerary& itinerary) {
+    std::string text;
+    for (const ItineraryLeg& leg : itinerary.legs) {
+        text += leg.from.str() + "-";
+    }
+    return itinerary.legs.empty() ? text : text + itinerary.legs.back().to.str();
+}
+
+// (primary, secondary) cost of an itinerary in the query's order
+using Cost = std::pair<double, double>;
+
+Cost costOf(const ItineraryQuery& query, double miles, size_t legs) {
+    if (query.order == ItineraryQuery::Order::kFewestLegs) {
+        return Cost(static_cast<double>(legs), miles);
+    }
+    return Cost(miles, static_cast<double>(legs));
+}
+
+// Costs of every simple path from `from` to `to` the query allows, best
+// first
+std::vector<Cost> allItineraries(const Network& net, uint32_t from, uint32_t to,
+                                 const ItineraryQuery& query) {
+    std::vector<Cost> costs;
+    std::vector<uint32_t> excluded;
+    for (IataCode code : query.excluded) {
+        excluded.push_back(net.routes.airportCodes().find(code));
+    }
+    std::vector<uint32_t> visited{from};
+    std::function<void(uint32_t, uint32_t, double, size_t)> walk =
+        [&](uint32_t a, uint32_t airline, double miles, size_t legs) {
+            if (a == to) {
+                costs.push_back(costOf(query, miles, legs));
+                return;
+            }
+            if (legs == query.max_legs) {
+                return;
+            }
+            IdSpan rows = net.routes_by_source.rows(a);
+            IdSpan next = net.routes_by_source.neighbors(a);
+            for (size_t first = 0, last = 0; first < next.size(); first = last) {
+                uint32_t b = next[first];
+                for (last = first + 1; last < next.size() && next[last] == b; ++last) {
+                }
+                if (!net.usable[b] ||
+                    std::find(visited.begin(), visited.end(), b) != visited.end() ||
+                    std::find(excluded.begin(), excluded.end(), b) != excluded.end()) {
+                    continue;
+                }
+                visited.push_back(b);
+                double leg_miles = net.routes.miles(rows[first]);
+                if (!query.same_airline) {
+                    walk(b, airline, miles + leg_miles, legs + 1);
+                } else {
+                    std::vector<uint32_t> airlines;
+                    for (size_t i = first; i < last; ++i) {
+                        uint32_t carrier = net.routes.airline(rows[i]);
+                        if (airline == CodeDictionary::kNone || carrier == airline) {
+                            airlines.push_back(carrier);
+                        }
+                    }
+                    std::sort(airlines.begin(), airlines.end());
+                    airlines.erase(std::unique(airlines.begin(), airlines.end()), airlines.end());
+                    for (uint32_t carrier : airlines) {
+                        walk(b, carrier, miles + leg_miles, legs + 1);
+                    }
+                }
+                visited.pop_back();
+            }
+        };
+    if (from != to) {
+        walk(from, CodeDictionary::kNone, 0.0, 0);
+    }
+    std::sort(costs.begin(), costs.end());
+    return costs;
+}
+
+// Itineraries are well formed: legs chain from source to dest over usable,
+// non-excluded airports, never revisit one, and add up to the total
+void checkShape(const Network& net, const ItineraryResult& result, IataCode source,
+                IataCode dest, const ItineraryQuery& query) {
+    for (const Itinerary& itinerary : result.itineraries) {
+        CHECK(!itinerary.legs.empty());
+        CHECK(itinerary.legs.size() <= query.max_legs);
+        if (itinerary.legs.empty()) {
+            continue;
+        }
+        CHECK(itinerary.legs.front().from == source);
+        CHECK(itinerary.legs.back().to == dest);
+        std::vector<IataCode> visited{source};
+        double miles = 0.0;
+        for (size_t i = 0; i < itinerary.legs.size(); ++i) {
+            const ItineraryLeg& leg = itinerary.legs[i];
+            CHECK(i == 0 || leg.from == itinerary.legs[i - 1].to);
+            CHECK(std::find(visited.begin(), visited.end(), leg.to) == visited.end());
+            CHECK(std::find(query.excluded.begin(), query.excluded.end(), leg.to) ==
+                  query.excluded.end());
+            CHECK(net.usable[net.routes.airportCodes().find(leg.to)]);
+            CHECK(!leg.airlines.empty());
+            if (query.same_airline && !leg.airlines.empty()) {
+                CHECK(leg.airlines.size() == 1);
+                CHECK(leg.airlines[0] == itinerary.legs[0].airlines[0]);
+            }
+            visited.push_back(leg.to);
+            miles += leg.miles;
+        }
+        CHECK(std::fabs(miles - itinerary.miles) < 1e-6);
+    }
+}
+
+bool sameCosts(const ItineraryQuery& query, const ItineraryResult& result,
+               const std::vector<Cost>& all) {
+    size_t want = std::min(all.size(), query.limit);
+    if (result.itineraries.size() != want) {
+        return false;
+    }
+    for (size_t i = 0; i < want; ++i) {
+        const Itinerary& itinerary = result.itineraries[i];
+        Cost cost = costOf(query, itinerary.miles, itinerary.legs.size());
+        if (std::fabs(cost.first - all[i].first) > 1e-6 ||
+            std::fabs(cost.second - all[i].second) > 1e-6) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // A -> X -> B is the shorter way to B, so a search that kept one
+    // partial itinerary per airport kept it and lost A -> Y -> B -> X -> D,
+    // the only itinerary besides A -> X -> D (B -> X -> D would revisit X)
+    {
+        std::map<std::string, std::pair<double, double>> airports = {
+            {"AAA", {0.0, 0.0}}, {"XXX", {0.0, 1.0}}, {"YYY", {3.0, 1.0}},
+            {"BBB", {0.0, 2.0}}, {"DDD", {0.0, 3.0}}};
+        Network net({route("ZZ", "AAA", "XXX"), route("ZZ", "XXX", "BBB"),
+                     route("ZZ", "AAA", "YYY"), route("ZZ", "YYY", "BBB"),
+                     route("ZZ", "BBB", "XXX"), route("ZZ", "XXX", "DDD")},
+                    airports);
+        ItineraryQuery query;
+        query.max_legs = 4;
+        query.limit = 5;
+        for (auto order : {ItineraryQuery::Order::kShortest, ItineraryQuery::Order::kFewestLegs}) {
+            query.order = order;
+            ItineraryResult result = net.find("AAA", "DDD", query);
+            CHECK(result.itineraries.size() == 2);
+            CHECK(!result.truncated);
+            if (result.itineraries.size() == 2) {
+                CHECK(path(result.itineraries[0]) == "AAA-XXX-DDD");
+                CHECK(path(result.itineraries[1]) == "AAA-YYY-BBB-XXX-DDD");
+            }
+        }
+        // Within three legs only the direct way is left; A -> B has both
+        // ways, best first
+        query.max_legs = 3;
+        CHECK(net.find("AAA", "DDD", query).itineraries.size() == 1);
+        query.order = ItineraryQuery::Order::kShortest;
+        query.limit = 5;
+        ItineraryResult to_b = net.find("AAA", "BBB", query);
+        CHECK(to_b.itineraries.size() == 2);
+        if (to_b.itineraries.size() == 2) {
+            CHECK(path(to_b.itineraries[0]) == "AAA-XXX-BBB");
+            CHECK(path(to_b.itineraries[1]) == "AAA-YYY-BBB");
+        }
+        // Excluding Y leaves only the direct way
+        query.max_legs = 4;
+        query.excluded = {IataCode("YYY")};
+        CHECK(net.find("AAA", "DDD", query).itineraries.size() == 1);
+        // Unknown airports, the same airport, and empty queries
+        query.excluded.clear();
+        CHECK(net.find("AAA", "QQQ", query).itineraries.empty());
+        CHECK(net.find("AAA", "AAA", query).itineraries.empty());
+        query.limit = 0;
+        CHECK(net.find("AAA", "BBB", query).itineraries.empty());
+    }
+
+    // Twelve airports, every one flying to every other: far more partial
+    // itineraries than kMaxNodes, so the search stops early and says so,
+    // and what it returns is still the best, in order
+    {
+        std::map<std::string, std::pair<double, double>> airports;
+        std::vector<Route> routes;
+        for (int a = 0; a < 12; ++a) {
+            airports["K" + std::to_string(10 + a)] = {a * 0.7, (a * a) % 11 * 0.9};
+            for (int b = 0; b < 12; ++b) {
+                if (a != b) {
+                    routes.push_back(route("ZZ", "K" + std::to_string(10 + a), "K" + std::to_string(10 + b)));
+                }
+            }
+        }
+        Network net(routes, airports);
+        ItineraryQuery query;
+        query.max_legs = 11;
+        query.limit = 5000000;
+        ItineraryResult result = net.find("K10", "K11", query);
+        CHECK(result.truncated);
+        CHECK(!result.itineraries.empty());
+        for (size_t i = 1; i < result.itineraries.size(); ++i) {
+            CHECK(result.itineraries[i - 1].miles <= result.itineraries[i].miles + 1e-9);
+        }
+        query.limit = 20;
+        ItineraryResult top = net.find("K10", "K11", query);
+        CHECK(!top.truncated);
+        CHECK(top.itineraries.size() == 20);
+        for (size_t i = 0; i < top.itineraries.size() && i < result.itineraries.size(); ++i) {
+            CHECK(std::fabs(top.itineraries[i].miles - result.itineraries[i].miles) < 1e-9);
+        }
+    }
+
+    // routes.dat, with the airports.dat positions; routes touching an
+    // airport missing from airports.dat are unusable as in Database
+    std::map<std::string, std::pair<double, double>> airports;
+    for (const std::string& line : readLines(dataFile(argc, argv, "airports.dat"))) {
+        Airport airport = CSVParser::parseAirport(line);
+        if (airport.id > 0 && !airport.iata.empty() && airport.iata != "\\N") {
+            airports[airport.iata] = {airport.latitude, airport.longitude};
+        }
+    }
+    std::vector<Route> route_list;
+    for (const std::string& line : readLines(dataFile(argc, argv, "routes.dat"))) {
+        Route r = CSVParser::parseRoute(line);
+        IataCode code;
+        if (IataCode::parse(r.airline_iata, code) && IataCode::parse(r.source_iata, code) &&
+            IataCode::parse(r.dest_iata, code)) {
+            route_list.push_back(r);
+        }
+    }
+    CHECK(route_list.size() > 60000);
+    auto net = std::make_unique<Network>(route_list, airports);
+    const CodeDictionary& codes = net->routes.airportCodes();
+    std::vector<uint32_t> usable;
+    for (uint32_t a = 0; a < codes.size(); ++a) {
+        if (net->usable[a]) {
+            usable.push_back(a);
+        }
+    }
+
+    std::mt19937 rng(23);
+    for (int q = 0; q < 120; ++q) {
+        uint32_t from = usable[rng() % usable.size()];
+        uint32_t to = usable[rng() % usable.size()];
+        IdSpan next = net->routes_by_source.neighbors(from);
+        if (q % 3 == 0 && !next.empty()) {
+            to = next[rng() % next.size()];
+        }
+        ItineraryQuery query;
+        query.max_legs = 1 + rng() % 3;
+        query.limit = 1 + rng() % 8;
+        query.order = rng() % 2 ? ItineraryQuery::Order::kFewestLegs : ItineraryQuery::Order::kShortest;
+        query.same_airline = rng() % 3 == 0;
+        if (q % 5 == 0 && !next.empty()) {
+            query.excluded.push_back(codes.at(next[rng() % next.size()]));
+        }
+
+        ItineraryResult result = net->find(codes.at(from).str(), codes.at(to).str(), query);
+        std::vector<Cost> all = allItineraries(*net, from, to, query);
+        CHECK(!result.truncated);
+        if (!sameCosts(query, result, all)) {
+            std::cerr << codes.at(from).str() << " -> " << codes.at(to).str() << " differs\n";
+            CHECK(false);
+        }
+        checkShape(*net, result, codes.at(from), codes.at(to), query);
+    }
+
+    return testResult();
+}
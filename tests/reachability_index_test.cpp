@@ -0,0 +1,212 @@
+// ReachabilityIndex against a breadth-first search over the same links,
+// on a small hand-made graph and on the routes.dat airports, and its
+// in-place link updates against a fresh build.
+#include "check.h"
+#include "../include/csv_parser.h"
+#include "../include/reachability_index.h"
+#include "../include/route_table.h"
+#include <algorithm>
+#include <random>
+
+namespace {
+
+// Fewest flights from source to every airport through usable airports,
+// capped as hops() caps them
+std::vector<uint32_t> bfsHops(const CsrIndex& routes_by_source, size_t airports, uint32_t source,
+                              const ReachabilityIndex::Usable& usable) {
+    std::vector<uint32_t> hops(airports, static_cast<uint32_t>(ReachabilityIndex::kUnreachable));
+    hops[source] = 0;
+    if (!usable(source)) {
+        return hops;
+    }
+    std::vector<uint32_t> queue{source};
+    for (size_t i = 0; i < queue.size(); ++i) {
+        uint32_t a = queue[i];
+        if (hops[a] == ReachabilityIndex::kMaxHops) {
+            continue;
+        }
+        for (uint32_t b : routes_by_source.neighbors(a)) {
+            if (b < airports && usable(b) && hops[b] == ReachabilityIndex::kUnreachable) {
+                hops[b] = hops[a] + 1;
+                queue.push_back(b);
+            }
+        }
+    }
+    return hops;
+}
+
+void checkSources(const ReachabilityIndex& index, const CsrIndex& routes_by_source,
+                  size_t airports, const std::vector<uint32_t>& sources,
+                  const ReachabilityIndex::Usable& usable) {
+    for (uint32_t source : sources) {
+        std::vector<uint32_t> expected = bfsHops(routes_by_source, airports, source, usable);
+        for (uint32_t to = 0; to < airports; ++to) {
+            CHECK(index.hops(source, to) == expected[to]);
+        }
+    }
+}
+
+bool sameIndex(const ReachabilityIndex& a, const ReachabilityIndex& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (uint32_t from = 0; from < a.size(); ++from) {
+        for (uint32_t to = 0; to < a.size(); ++to) {
+            if (a.hops(from, to) != b.hops(from, to)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Empty index
+    ReachabilityIndex empty;
+    CHECK(empty.size() == 0);
+    CHECK(empty.hops(0, 0) == ReachabilityIndex::kUnreachable);
+    empty.addLink(0, 1);
+    CHECK(empty.size() == 0);
+
+    // A chain 0 -> 1 -> 2 -> 3 -> 4 with a shortcut 0 -> 5 -> 4 through an
+    // airport that starts unusable
+    {
+        std::vector<uint32_t> sources = {0, 1, 2, 3, 0, 5};
+        std::vector<uint32_t> dests = {1, 2, 3, 4, 5, 4};
+        CsrIndex links;
+        links.build(sources, 6, dests);
+        bool five_usable = false;
+        auto usable = [&](uint32_t a) { return a != 5 || five_usable; };
+        ReachabilityIndex index;
+        index.build(links, 6, usable);
+        CHECK(index.hops(0, 0) == 0);
+        CHECK(index.hops(0, 1) == 1);
+        CHECK(index.hops(0, 3) == 3);
+        CHECK(index.hops(0, 4) == ReachabilityIndex::kUnreachable);
+        CHECK(index.hops(0, 5) == ReachabilityIndex::kUnreachable);
+        CHECK(index.hops(4, 0) == ReachabilityIndex::kUnreachable);
+        CHECK(index.hops(0, 6) == ReachabilityIndex::kUnreachable);
+
+        five_usable = true;
+        index.build(links, 6, usable);
+        CHECK(index.hops(0, 4) == 2);
+        CHECK(index.hops(0, 5) == 1);
+
+        // 3 -> 0 closes a cycle: 1 now reaches 0 in 3 flights
+        sources.push_back(3);
+        dests.push_back(0);
+        links.insert(3, 6, 0);
+        index.addLink(3, 0);
+        CHECK(index.hops(1, 0) == 3);
+        CHECK(index.hops(3, 5) == 2);
+        CHECK(index.hops(2, 5) == 3);
+
+        // Dropping 0 -> 5 leaves 0 -> 4 only the long way
+        links.erase(0, 4, 5);
+        index.removeLink(0, links, usable);
+        CHECK(index.hops(0, 5) == ReachabilityIndex::kUnreachable);
+        CHECK(index.hops(0, 4) == ReachabilityIndex::kUnreachable);
+        CHECK(index.hops(2, 4) == 2);
+    }
+
+    // The routes.dat network, with every 17th airport unusable
+    RouteTable routes;
+    for (const std::string& line : readLines(dataFile(argc, argv, "routes.dat"))) {
+        Route route = CSVParser::parseRoute(line);
+        IataCode code;
+        if (IataCode::parse(route.airline_iata, code) && IataCode::parse(route.source_iata, code) &&
+            IataCode::parse(route.dest_iata, code)) {
+            routes.append(route);
+        }
+    }
+    CHECK(routes.size() > 60000);
+    size_t airports = routes.airportCodes().size();
+    auto usable = [](uint32_t a) { return a % 17 != 0; };
+    std::vector<uint32_t> sources = routes.sourceColumn();
+    std::vector<uint32_t> dests = routes.destColumn();
+    CsrIndex links;
+    links.build(sources, airports, dests);
+    ReachabilityIndex index;
+    index.build(links, airports, usable);
+    CHECK(index.size() == airports);
+
+    std::mt19937 rng(24);
+    std::vector<uint32_t> sample;
+    for (int i = 0; i < 150; ++i) {
+        sample.push_back(rng() % airports);
+    }
+    checkSources(index, links, airports, sample, usable);
+
+    // Links added and removed one at a time, as route writes make them;
+    // removeLink() follows only the removal of the last route of a pair
+    for (int step = 0; step < 200; ++step) {
+        if (rng() % 2 == 0) {
+            uint32_t from = rng() % airports;
+            uint32_t to = rng() % airports;
+            if (!usable(from) || !usable(to)) {
+                continue;
+            }
+            links.insert(from, static_cast<uint32_t>(sources.size()), to);
+            sources.push_back(from);
+            dests.push_back(to);
+            index.addLink(from, to);
+        } else {
+            uint32_t row = rng() % sources.size();
+            uint32_t from = sources[row];
+            uint32_t to = dests[row];
+            links.eraseRows({row});
+            sources.erase(sources.begin() + row);
+            dests.erase(dests.begin() + row);
+            IdSpan left = links.neighbors(from);
+            if (!std::binary_search(left.begin(), left.end(), to) && usable(from) && usable(to)) {
+                index.removeLink(from, links, usable);
+            }
+        }
+    }
+    ReachabilityIndex fresh;
+    fresh.build(links, airports, usable);
+    CHECK(sameIndex(index, fresh));
+    checkSources(index, links, airports, sample, usable);
+
+    // Removing every route out of a few busy airports
+    for (uint32_t from : {sources[0], sources[sources.size() / 2]}) {
+        while (!links.rows(from).empty()) {
+            uint32_t row = links.rows(from)[0];
+            links.eraseRows({row});
+            sources.erase(sources.begin() + row);
+            dests.erase(dests.begin() + row);
+        }
+        index.removeLink(from, links, usable);
+    }
+    fresh.build(links, airports, usable);
+    CHECK(sameIndex(index, fresh));
+
+    // New airports: grow() keeps every answer, and links to and from the
+    // new airports update it like any other
+    index.grow(airports + 70);
+    CHECK(index.size() == airports + 70);
+    for (uint32_t from = 0; from < airports; from += 13) {
+        for (uint32_t to = 0; to < airports; to += 7) {
+            CHECK(index.hops(from, to) == fresh.hops(from, to));
+        }
+        CHECK(index.hops(from, static_cast<uint32_t>(airports + 1)) == ReachabilityIndex::kUnreachable);
+    }
+    size_t grown = airports + 70;
+    for (int i = 0; i < 40; ++i) {
+        uint32_t from = static_cast<uint32_t>(i % 2 ? airports + rng() % 70 : rng() % grown);
+        uint32_t to = static_cast<uint32_t>(i % 2 ? rng() % grown : airports + rng() % 70);
+        if (!usable(from) || !usable(to)) {
+            continue;
+        }
+        links.insert(from, static_cast<uint32_t>(sources.size()), to);
+        sources.push_back(from);
+        dests.push_back(to);
+        index.addLink(from, to);
+    }
+    fresh.build(links, grown, usable);
+    CHECK(sameIndex(index, fresh));
+
+    return testResult();
+}
@@ -0,0 +1,215 @@
+// The schema-generated record decoders against the hand-written
+// std::stoi / std::stod decoders they replaced: the same numbers from null,
+// empty, signed, padded, overflowing and non-numeric fields, and the same
+// records (or the same rejection) from every bundled row and from rows
+// with those fields or too few columns.
+#include "check.h"
+#include "../include/csv_parser.h"
+#include "../include/record_schema.h"
+#include <cmath>
+#include <cstring>
+#include <string>
+
+namespace {
+
+int baselineInt(const std::string& s, int defaultVal = -1) {
+    if (s.empty() || s == "\\N" || s == "N/A") {
+        return defaultVal;
+    }
+    try {
+        return std::stoi(s);
+    } catch (...) {
+        return defaultVal;
+    }
+}
+
+double baselineDouble(const std::string& s, double defaultVal = 0.0) {
+    if (s.empty() || s == "\\N" || s == "N/A") {
+        return defaultVal;
+    }
+    try {
+        return std::stod(s);
+    } catch (...) {
+        return defaultVal;
+    }
+}
+
+std::string baselineString(const std::string& s) {
+    if (s == "\\N" || s == "N/A") {
+        return "";
+    }
+    return s;
+}
+
+// The baseline decoders filled whatever a wide enough row had; the loaders
+// then dropped rows without the codes they key on. decodeRecord() does the
+// dropping itself, leaving the record untouched, so a dropped row is
+// expected to come back default-constructed.
+bool baselineAirline(const std::vector<std::string>& f, Airline& a) {
+    if (f.size() < 8) {
+        return false;
+    }
+    a.id = baselineInt(f[0]);
+    a.name = baselineString(f[1]);
+    a.alias = baselineString(f[2]);
+    a.iata = baselineString(f[3]);
+    a.icao = baselineString(f[4]);
+    a.callsign = baselineString(f[5]);
+    a.country = baselineString(f[6]);
+    a.active = baselineString(f[7]);
+    return !a.iata.empty();
+}
+
+bool baselineAirport(const std::vector<std::string>& f, Airport& a) {
+    if (f.size() < 14) {
+        return false;
+    }
+    a.id = baselineInt(f[0]);
+    a.name = baselineString(f[1]);
+    a.city = baselineString(f[2]);
+    a.country = baselineString(f[3]);
+    a.iata = baselineString(f[4]);
+    a.icao = baselineString(f[5]);
+    a.latitude = baselineDouble(f[6]);
+    a.longitude = baselineDouble(f[7]);
+    a.altitude = baselineInt(f[8]);
+    a.timezone = baselineDouble(f[9]);
+    a.dst = baselineString(f[10]);
+    a.tz = baselineString(f[11]);
+    a.type = baselineString(f[12]);
+    a.source = baselineString(f[13]);
+    return !a.iata.empty();
+}
+
+bool baselineRoute(const std::vector<std::string>& f, Route& r) {
+    if (f.size() < 9) {
+        return false;
+    }
+    r.airline_iata = baselineString(f[0]);
+    r.airline_id = baselineInt(f[1]);
+    r.source_iata = baselineString(f[2]);
+    r.source_id = baselineInt(f[3]);
+    r.dest_iata = baselineString(f[4]);
+    r.dest_id = baselineInt(f[5]);
+    r.codeshare = baselineString(f[6]);
+    r.stops = baselineInt(f[7]);
+    r.equipment = baselineString(f[8]);
+    return !r.airline_iata.empty() && !r.source_iata.empty() && !r.dest_iata.empty();
+}
+
+// Doubles compare by bits, so NaNs and signed zeros count too
+bool sameDouble(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0 || (std::isnan(a) && std::isnan(b));
+}
+
+bool same(const Airline& a, const Airline& b) {
+    return a.id == b.id && a.name == b.name && a.alias == b.alias && a.iata == b.iata &&
+           a.icao == b.icao && a.callsign == b.callsign && a.country == b.country &&
+           a.active == b.active;
+}
+
+bool same(const Airport& a, const Airport& b) {
+    return a.id == b.id && a.name == b.name && a.city == b.city && a.country == b.country &&
+           a.iata == b.iata && a.icao == b.icao && sameDouble(a.latitude, b.latitude) &&
+           sameDouble(a.longitude, b.longitude) && a.altitude == b.altitude &&
+           sameDouble(a.timezone, b.timezone) && a.dst == b.dst && a.tz == b.tz &&
+           a.type == b.type && a.source == b.source;
+}
+
+bool same(const Route& a, const Route& b) {
+    return a.airline_iata == b.airline_iata && a.airline_id == b.airline_id &&
+           a.source_iata == b.source_iata && a.source_id == b.source_id &&
+           a.dest_iata == b.dest_iata && a.dest_id == b.dest_id && a.codeshare == b.codeshare &&
+           a.stops == b.stops && a.equipment == b.equipment;
+}
+
+std::string joined(const std::vector<std::string>& fields) {
+    std::string line;
+    for (size_t i = 0; i < fields.size(); ++i) {
+        line += (i ? "," : "") + fields[i];
+    }
+    return line;
+}
+
+// decodeRecord() keeps exactly the rows the baseline kept, with the same
+// fields, and so does the CSVParser wrapper around it
+template <typename Record, typename Baseline, typename Wrapper>
+void checkRow(const std::vector<std::string>& fields, Baseline baseline, Wrapper wrapper) {
+    std::vector<std::string_view> views(fields.begin(), fields.end());
+    Record expected;
+    bool expected_kept = baseline(fields, expected);
+    if (!expected_kept) {
+        expected = Record();
+    }
+    Record decoded;
+    bool kept = schema::decodeRecord(views, decoded);
+    bool ok = kept == expected_kept && same(decoded, expected) && same(wrapper(views), expected);
+    if (!ok) {
+        std::cerr << "decodes differently: " << joined(fields) << "\n";
+    }
+    CHECK(ok);
+}
+
+// Field values that a numeric column may hold
+const std::vector<std::string> kNumbers = {
+    "\\N", "N/A", "", "0", "-0", "17", "-17", "+17", "+-17", "-+17", " 42", "\t42", " \n-42",
+    "42 ", "42abc", "abc", "-", "+", " ", "2147483647", "-2147483648", "2147483648",
+    "-2147483649", "99999999999999999999", "007", "1.5", "-1.5", ".5", "-.5", "5.", "1e3",
+    "1E-3", "-1e+3", "1e", "1e+", "1e400", "-1e400", "1e-400", "4.9e-324", "2.2e-308",
+    "1.7976931348623157e308", "0.1234567890123456789", "inf", "-inf", "INF", "infinity",
+    "nan", "NaN", "0x1A", "0X1a", "-0x1p3", "+0x1p3", "0x", "0xg", "0x1p-1074", "0x1p3", "--5", "..5", "1,5", "N", "\\", "\\N0", "n/a",
+};
+
+template <typename Record, typename Baseline, typename Wrapper>
+void checkRows(const std::string& path, Baseline baseline, Wrapper wrapper) {
+    std::vector<std::string> lines = readLines(path);
+    CHECK(!lines.empty());
+    for (const std::string& line : lines) {
+        checkRow<Record>(CSVParser::parseLine(line), baseline, wrapper);
+    }
+    if (lines.empty()) {
+        return;
+    }
+
+    // The first row with each column replaced by every numeric case, and
+    // cut short or padded by one column
+    std::vector<std::string> row = CSVParser::parseLine(lines.front());
+    for (size_t column = 0; column < row.size(); ++column) {
+        for (const std::string& value : kNumbers) {
+            std::vector<std::string> changed = row;
+            changed[column] = value;
+            checkRow<Record>(changed, baseline, wrapper);
+        }
+    }
+    for (size_t width = 0; width <= row.size() + 1; ++width) {
+        std::vector<std::string> resized = row;
+        resized.resize(width, "extra");
+        checkRow<Record>(resized, baseline, wrapper);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (const std::string& s : kNumbers) {
+        bool ok = schema::toInt(s, -1) == baselineInt(s) && CSVParser::parseInt(s) == baselineInt(s) &&
+                  sameDouble(schema::toDouble(s, 0.0), baselineDouble(s)) &&
+                  sameDouble(CSVParser::parseDouble(s), baselineDouble(s));
+        if (!ok) {
+            std::cerr << "converts differently: \"" << s << "\" int " << schema::toInt(s, -1) << " vs "
+                      << baselineInt(s) << ", double " << schema::toDouble(s, 0.0) << " vs "
+                      << baselineDouble(s) << "\n";
+        }
+        CHECK(ok);
+        CHECK(CSVParser::cleanString(s) == baselineString(s));
+    }
+
+    checkRows<Airline>(dataFile(argc, argv, "airlines.dat"), baselineAirline,
+                       [](const std::vector<std::string_view>& f) { return CSVParser::parseAirline(f); });
+    checkRows<Airport>(dataFile(argc, argv, "airports.dat"), baselineAirport,
+                       [](const std::vector<std::string_view>& f) { return CSVParser::parseAirport(f); });
+    checkRows<Route>(dataFile(argc, argv, "routes.dat"), baselineRoute,
+                     [](const std::vector<std::string_view>& f) { return CSVParser::parseRoute(f); });
+
+    return testResult();
+}
@@ -0,0 +1,338 @@
+// Database snapshots against the CSV load they were written from: every
+// read the endpoints make returns the same output from a database loaded
+// from the snapshot, before and after the same writes, and a snapshot that
+// no longer matches its sources or its own bytes is refused.
+#include "check.h"
+#include "../include/database.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream out;
+    out << in.rdbuf();
+    return out.str();
+}
+
+void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << data;
+}
+
+// A failed comparison names the read and the input it was given
+void checkSame(const std::string& what, const std::string& csv, const std::string& snapshot) {
+    if (csv != snapshot) {
+        std::cerr << "differs after the snapshot load: " << what << "\n";
+    }
+    CHECK(csv == snapshot);
+}
+
+void put(std::ostream& out, const AirlineView& a) {
+    out << a.id << '|' << a.name << '|' << a.alias << '|' << a.iata << '|' << a.icao << '|'
+        << a.callsign << '|' << a.country << '|' << a.active << '\n';
+}
+
+void put(std::ostream& out, const AirportView& a) {
+    out << a.id << '|' << a.name << '|' << a.city << '|' << a.country << '|' << a.iata << '|'
+        << a.icao << '|' << a.latitude << '|' << a.longitude << '|' << a.altitude << '|'
+        << a.timezone << '|' << a.dst << '|' << a.tz << '|' << a.type << '|' << a.source << '\n';
+}
+
+void put(std::ostream& out, const Airline& a) {
+    out << a.id << '|' << a.name << '|' << a.alias << '|' << a.iata << '|' << a.icao << '|'
+        << a.callsign << '|' << a.country << '|' << a.active << '\n';
+}
+
+void put(std::ostream& out, const Airport& a) {
+    out << a.id << '|' << a.name << '|' << a.city << '|' << a.country << '|' << a.iata << '|'
+        << a.icao << '|' << a.latitude << '|' << a.longitude << '|' << a.altitude << '|'
+        << a.timezone << '|' << a.dst << '|' << a.tz << '|' << a.type << '|' << a.source << '\n';
+}
+
+std::ostringstream stream() {
+    std::ostringstream out;
+    out << std::setprecision(17);
+    return out;
+}
+
+// Whole-table reads
+std::string listings(const Database& db) {
+    std::ostringstream out = stream();
+    for (const AirlineView& a : db.airlinesSorted()) {
+        put(out, a);
+    }
+    for (const AirportView& a : db.airportsSorted()) {
+        put(out, a);
+    }
+    for (const Airline& a : db.getAllAirlinesSorted()) {
+        put(out, a);
+    }
+    for (const Airport& a : db.getAllAirportsSorted()) {
+        put(out, a);
+    }
+    for (const AirportTrafficView& entry : db.topAirports(100000)) {
+        out << entry.route_count << ' ' << entry.airline_count << ' ';
+        put(out, entry.airport);
+    }
+    out << db.getStudentInfo() << '\n';
+    return out.str();
+}
+
+// Reads keyed by one airline
+std::string airlineReads(const Database& db, IataCode code) {
+    std::ostringstream out = stream();
+    put(out, db.findAirline(code));
+    put(out, db.getAirlineByIATA(code));
+    for (const AirportCountView& entry : db.airportsServedBy(code)) {
+        out << entry.route_count << ' ';
+        put(out, entry.airport);
+    }
+    for (const AirportRouteCount& entry : db.getAirportsByAirline(code)) {
+        out << entry.route_count << ' ';
+        put(out, entry.airport);
+    }
+    return out.str();
+}
+
+// Reads keyed by one airport
+std::string airportReads(const Database& db, IataCode code) {
+    std::ostringstream out = stream();
+    put(out, db.findAirport(code));
+    put(out, db.getAirportByIATA(code));
+    for (const AirlineCountView& entry : db.airlinesServing(code)) {
+        out << entry.route_count << ' ';
+        put(out, entry.airline);
+    }
+    for (const AirlineRouteCount& entry : db.getAirlinesByAirport(code)) {
+        out << entry.route_count << ' ';
+        put(out, entry.airline);
+    }
+    return out.str();
+}
+
+std::string routeReads(const Database& db, IataCode source, IataCode dest) {
+    std::ostringstream out = stream();
+    for (const Database::DirectRoute& route : db.getDirectRoutes(source, dest)) {
+        out << route.airline_iata << ' ' << route.airline_name << ' ' << route.distance << ' '
+            << route.stops << '\n';
+    }
+    for (const Database::OneHopRoute& route : db.getOneHopRoutes(source, dest)) {
+        out << route.intermediate << ' ' << route.airline << ' ' << route.distance << ':';
+        for (const Database::AirlinePair& pair : route.airlines) {
+            out << ' ' << pair.first_leg << '/' << pair.second_leg;
+        }
+        out << '\n';
+    }
+    return out.str();
+}
+
+std::string itineraryReads(const Database& db, IataCode source, IataCode dest) {
+    std::ostringstream out = stream();
+    ItineraryQuery query;
+    for (auto order : {ItineraryQuery::Order::kShortest, ItineraryQuery::Order::kFewestLegs}) {
+        query.order = order;
+        ItineraryResult result = db.findItineraries(source, dest, query);
+        out << result.truncated << '\n';
+        for (const Itinerary& itinerary : result.itineraries) {
+            out << itinerary.miles << ':';
+            for (const ItineraryLeg& leg : itinerary.legs) {
+                out << ' ' << leg.from.str() << '-' << leg.to.str() << '/' << leg.miles;
+                for (IataCode airline : leg.airlines) {
+                    out << ',' << airline.str();
+                }
+            }
+            out << '\n';
+        }
+    }
+    return out.str();
+}
+
+std::string searchReads(const Database& db, const std::string& query) {
+    std::ostringstream out = stream();
+    for (const AirportView& a : db.searchAirports(query, 20)) {
+        put(out, a);
+    }
+    return out.str();
+}
+
+// Codes to probe: every nth one in code order plus the busiest airports,
+// so pair reads find routes
+std::vector<IataCode> sampleAirports(const Database& db) {
+    std::vector<IataCode> codes;
+    EntityRange<Airport> sorted = db.airportsSorted();
+    for (size_t i = 0; i < sorted.size(); i += 97) {
+        codes.push_back(IataCode(sorted[i].iata));
+    }
+    for (const AirportTrafficView& entry : db.topAirports(40)) {
+        codes.push_back(IataCode(entry.airport.iata));
+    }
+    codes.push_back(IataCode("ZZZ"));
+    return codes;
+}
+
+void checkReads(const Database& csv, const Database& snapshot) {
+    checkSame("listings", listings(csv), listings(snapshot));
+
+    EntityRange<Airline> airlines = csv.airlinesSorted();
+    for (size_t i = 0; i < airlines.size(); i += 7) {
+        IataCode code(airlines[i].iata);
+        checkSame("airline " + code.str(), airlineReads(csv, code), airlineReads(snapshot, code));
+    }
+
+    std::vector<IataCode> sample = sampleAirports(csv);
+    std::vector<std::pair<IataCode, IataCode>> pairs;
+    for (IataCode a : sample) {
+        checkSame("airport " + a.str(), airportReads(csv, a), airportReads(snapshot, a));
+        for (IataCode b : sample) {
+            pairs.emplace_back(a, b);
+            checkSame("routes " + a.str() + "-" + b.str(), routeReads(csv, a, b),
+                      routeReads(snapshot, a, b));
+        }
+    }
+    for (size_t i = 0; i < pairs.size(); i += 23) {
+        const auto& pair = pairs[i];
+        checkSame("itineraries " + pair.first.str() + "-" + pair.second.str(),
+                  itineraryReads(csv, pair.first, pair.second),
+                  itineraryReads(snapshot, pair.first, pair.second));
+    }
+    CHECK(csv.hopCounts(pairs) == snapshot.hopCounts(pairs));
+
+    for (IataCode code : sample) {
+        AirportView airport = csv.findAirport(code);
+        std::string_view city = airport.city.empty() ? airport.city : airport.city.substr(1, 5);
+        for (const std::string& query : {code.str(), std::string(airport.name.substr(0, 4)),
+                                         std::string(city)}) {
+            checkSame("search " + query, searchReads(csv, query), searchReads(snapshot, query));
+        }
+    }
+    for (const std::string& query : {"a", "lo", "intl", "INTERNATIONAL", "zzzz"}) {
+        checkSame("search " + query, searchReads(csv, query), searchReads(snapshot, query));
+    }
+}
+
+// The same writes on both, each checked to do the same thing
+void applyWrites(Database& db, std::vector<bool>& outcomes) {
+    Route route;
+    route.airline_iata = "AA";
+    route.source_iata = "JFK";
+    route.dest_iata = "SYD";
+    route.equipment = "789";
+    outcomes.push_back(db.insertRoute(route).success);
+    route.source_iata = "SYD";
+    route.dest_iata = "GKA";
+    outcomes.push_back(db.insertRoute(route).success);
+
+    Airport airport = db.getAirportByIATA(IataCode("LHR"));
+    airport.name = "Heathrow Renamed";
+    outcomes.push_back(db.updateAirport("LHR", airport).success);
+    outcomes.push_back(db.deleteAirport("ORD").success);
+    outcomes.push_back(db.deleteAirline("UA").success);
+
+    Airport added;
+    added.name = "Snapshot Field";
+    added.iata = "QQX";
+    added.latitude = 10.5;
+    added.longitude = 20.25;
+    outcomes.push_back(db.insertAirport(added).success);
+    route.source_iata = "QQX";
+    route.dest_iata = "JFK";
+    outcomes.push_back(db.insertRoute(route).success);
+}
+
+struct TempDir {
+    std::string path;
+
+    TempDir() {
+        char name[] = "/tmp/airtravel_snapshot_test.XXXXXX";
+        path = ::mkdtemp(name) ? name : "";
+    }
+
+    ~TempDir() {
+        for (const char* file : {"airlines.dat", "airports.dat", "routes.dat", "db.snapshot",
+                                 "bad.snapshot"}) {
+            std::remove((path + "/" + file).c_str());
+        }
+        ::rmdir(path.c_str());
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    TempDir dir;
+    CHECK(!dir.path.empty());
+    std::vector<std::string> sources;
+    for (const char* name : {"airlines.dat", "airports.dat", "routes.dat"}) {
+        sources.push_back(dir.path + "/" + name);
+        writeFile(sources.back(), readFile(dataFile(argc, argv, name)));
+    }
+    const std::string snapshot_path = dir.path + "/db.snapshot";
+
+    Database csv;
+    CHECK(csv.loadAirlines(sources[0]));
+    CHECK(csv.loadAirports(sources[1]));
+    CHECK(csv.loadRoutes(sources[2]));
+    CHECK(csv.saveSnapshot(snapshot_path, sources));
+
+    Database snapshot;
+    CHECK(snapshot.loadSnapshot(snapshot_path, sources));
+    checkReads(csv, snapshot);
+
+    // The restored indexes take writes exactly as the built ones do
+    std::vector<bool> csv_outcomes, snapshot_outcomes;
+    applyWrites(csv, csv_outcomes);
+    applyWrites(snapshot, snapshot_outcomes);
+    CHECK(csv_outcomes == snapshot_outcomes);
+    checkReads(csv, snapshot);
+
+    // A rejected snapshot leaves the database empty, for the CSV load that
+    // follows
+    auto refused = [&](const std::string& path) {
+        Database db;
+        bool loaded = db.loadSnapshot(path, sources);
+        return !loaded && db.airlinesSorted().size() == 0 && db.airportsSorted().size() == 0;
+    };
+
+    // Damaged payloads: one flipped byte in the middle or at the end
+    const std::string good = readFile(snapshot_path);
+    const std::string bad_path = dir.path + "/bad.snapshot";
+    for (size_t at : {good.size() / 2, good.size() - 1}) {
+        std::string bad = good;
+        bad[at] ^= 0x20;
+        writeFile(bad_path, bad);
+        CHECK(refused(bad_path));
+    }
+
+    // Another format version; the version follows the 8-byte magic
+    std::string other_version = good;
+    uint32_t version;
+    std::memcpy(&version, &other_version[8], sizeof(version));
+    ++version;
+    std::memcpy(&other_version[8], &version, sizeof(version));
+    writeFile(bad_path, other_version);
+    CHECK(refused(bad_path));
+
+    // Stale sources: a new modification time alone, then a new size
+    struct stat st;
+    CHECK(::stat(sources[1].c_str(), &st) == 0);
+    struct timespec touched[2] = {st.st_atim, st.st_mtim};
+    touched[1].tv_sec += 1;
+    CHECK(::utimensat(AT_FDCWD, sources[1].c_str(), touched, 0) == 0);
+    CHECK(refused(snapshot_path));
+    struct timespec restored[2] = {st.st_atim, st.st_mtim};
+    CHECK(::utimensat(AT_FDCWD, sources[1].c_str(), restored, 0) == 0);
+    Database again;
+    CHECK(again.loadSnapshot(snapshot_path, sources));
+
+    std::ofstream(sources[2], std::ios::app) << "\n";
+    CHECK(refused(snapshot_path));
+
+    return testResult();
+}
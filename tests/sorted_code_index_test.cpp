@@ -0,0 +1,154 @@
+// SortedCodeIndex against the std::map it replaced, under single writes,
+// staged bulk loads and the seeks the paging and prefix endpoints use.
+#include "check.h"
+#include "../include/csv_parser.h"
+#include "../include/sorted_code_index.h"
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string>
+
+namespace {
+
+using Baseline = std::map<uint32_t, uint32_t>;
+
+void checkAgainst(const SortedCodeIndex& index, const Baseline& baseline) {
+    CHECK(index.size() == baseline.size());
+    CHECK(index.rows().size() == baseline.size());
+    size_t i = 0;
+    for (const auto& entry : baseline) {
+        if (i == index.size()) {
+            break;
+        }
+        CHECK(index.code(i).raw() == entry.first);
+        CHECK(index.row(i) == entry.second);
+        CHECK(index.rows()[i] == entry.second);
+        ++i;
+    }
+}
+
+size_t expectedLowerBound(const Baseline& baseline, IataCode code) {
+    return static_cast<size_t>(
+        std::distance(baseline.begin(), baseline.lower_bound(code.raw())));
+}
+
+// Positions of the codes whose text starts with prefix, by scanning
+std::pair<size_t, size_t> expectedPrefixRange(const Baseline& baseline,
+                                              const std::string& prefix) {
+    size_t first = SIZE_MAX;
+    size_t last = 0;
+    size_t i = 0;
+    for (const auto& entry : baseline) {
+        if (IataCode::fromRaw(entry.first).str().compare(0, prefix.size(), prefix) == 0) {
+            first = std::min(first, i);
+            last = i + 1;
+        }
+        ++i;
+    }
+    if (first == SIZE_MAX) {
+        return {SIZE_MAX, SIZE_MAX};
+    }
+    return {first, last};
+}
+
+void checkSeeks(const SortedCodeIndex& index, const Baseline& baseline,
+                const std::vector<std::string>& probes) {
+    for (const std::string& probe : probes) {
+        IataCode code(probe);
+        CHECK(index.lowerBound(code) == expectedLowerBound(baseline, code));
+        std::pair<size_t, size_t> range = index.prefixRange(probe);
+        std::pair<size_t, size_t> expected = expectedPrefixRange(baseline, probe);
+        if (expected.first == SIZE_MAX) {
+            CHECK(range.first == range.second);
+        } else {
+            CHECK(range == expected);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<IataCode> codes;
+    for (const std::string& line : readLines(dataFile(argc, argv, "airports.dat"))) {
+        Airport airport = CSVParser::parseAirport(line);
+        IataCode code;
+        if (!airport.iata.empty() && airport.iata != "\\N" && IataCode::parse(airport.iata, code)) {
+            codes.push_back(code);
+        }
+    }
+    CHECK(codes.size() > 5000);
+
+    std::vector<std::string> probes = {"", "A", "J", "JF", "JFK", "JFKX", "Z", "ZZZ", "ZZZZ", "0", "a"};
+    for (size_t i = 0; i < codes.size(); i += 97) {
+        std::string code = codes[i].str();
+        probes.push_back(code);
+        probes.push_back(code.substr(0, 1));
+        probes.push_back(code.substr(0, 2));
+    }
+
+    // Empty index
+    SortedCodeIndex index;
+    Baseline baseline;
+    checkAgainst(index, baseline);
+    checkSeeks(index, baseline, probes);
+    index.erase(IataCode("JFK"));
+    index.merge();
+    CHECK(index.size() == 0);
+
+    // Bulk load: the last staged row for a code wins
+    for (size_t row = 0; row < codes.size(); ++row) {
+        index.stage(codes[row], static_cast<uint32_t>(row));
+        baseline[codes[row].raw()] = static_cast<uint32_t>(row);
+    }
+    index.merge();
+    checkAgainst(index, baseline);
+    checkSeeks(index, baseline, probes);
+
+    // Single sets and erases, mixed with staged batches merged into a
+    // non-empty index
+    std::mt19937 rng(16);
+    for (int i = 0; i < 4000; ++i) {
+        IataCode code = codes[rng() % codes.size()];
+        uint32_t row = rng() % 100000;
+        switch (rng() % 4) {
+        case 0:
+            index.erase(code);
+            baseline.erase(code.raw());
+            break;
+        case 1:
+            index.stage(code, row);
+            baseline[code.raw()] = row;
+            if (rng() % 8 == 0) {
+                index.merge();
+            }
+            break;
+        default:
+            index.set(code, row);
+            baseline[code.raw()] = row;
+            break;
+        }
+    }
+    index.merge();
+    checkAgainst(index, baseline);
+    checkSeeks(index, baseline, probes);
+
+    // Appends in code order, as a snapshot load writes them
+    SortedCodeIndex appended;
+    for (const auto& entry : baseline) {
+        appended.set(IataCode::fromRaw(entry.first), entry.second);
+    }
+    checkAgainst(appended, baseline);
+
+    // Erasing everything
+    for (IataCode code : codes) {
+        index.erase(code);
+        baseline.erase(code.raw());
+    }
+    checkAgainst(index, baseline);
+    checkSeeks(index, baseline, probes);
+
+    return testResult();
+}
@@ -0,0 +1,176 @@
+// TrigramIndex against the scan it replaced: every airport whose
+// lowercased code or name contains the lowercased query, sorted as the
+// search box sorts them, on the airports.dat codes and names.
+#include "check.h"
+#include "../include/csv_parser.h"
+#include "../include/trigram_index.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+
+namespace {
+
+std::string lower(std::string text) {
+    for (char& c : text) {
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+    }
+    return text;
+}
+
+bool startsWith(const std::string& text, const std::string& prefix) {
+    return text.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Code -> name
+using Baseline = std::map<uint32_t, std::string>;
+
+std::vector<IataCode> naiveSearch(const Baseline& baseline, const std::string& query, size_t limit) {
+    struct Match {
+        int rank;
+        std::string code;
+        uint32_t raw;
+    };
+    std::string q = lower(query);
+    std::vector<IataCode> codes;
+    if (q.empty()) {
+        return codes;
+    }
+    std::vector<Match> found;
+    for (const auto& entry : baseline) {
+        std::string code = lower(IataCode::fromRaw(entry.first).str());
+        std::string name = lower(entry.second);
+        if (code.find(q) == std::string::npos && name.find(q) == std::string::npos) {
+            continue;
+        }
+        int rank = (code == q ? 0 : 4) + (startsWith(code, q) ? 0 : 2) + (startsWith(name, q) ? 0 : 1);
+        found.push_back(Match{rank, code, entry.first});
+    }
+    std::sort(found.begin(), found.end(), [](const Match& a, const Match& b) {
+        if (a.rank != b.rank) {
+            return a.rank < b.rank;
+        }
+        if (a.code != b.code) {
+            return a.code < b.code;
+        }
+        return a.raw < b.raw;
+    });
+    for (size_t i = 0; i < found.size() && i < limit; ++i) {
+        codes.push_back(IataCode::fromRaw(found[i].raw));
+    }
+    return codes;
+}
+
+void checkQueries(const TrigramIndex& index, const Baseline& baseline,
+                  const std::vector<std::string>& queries) {
+    CHECK(index.size() == baseline.size());
+    for (const std::string& query : queries) {
+        for (size_t limit : {size_t(1), size_t(15), size_t(100000)}) {
+            std::vector<IataCode> got = index.search(query, limit);
+            std::vector<IataCode> expected = naiveSearch(baseline, query, limit);
+            CHECK(got.size() == expected.size());
+            bool same = got.size() == expected.size();
+            for (size_t i = 0; same && i < got.size(); ++i) {
+                same = got[i] == expected[i];
+            }
+            if (!same) {
+                std::cerr << "query \"" << query << "\" limit " << limit << " differs\n";
+                CHECK(same);
+            }
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Empty index
+    TrigramIndex index;
+    CHECK(index.size() == 0);
+    CHECK(index.search("a", 15).empty());
+    CHECK(index.search("lon", 15).empty());
+    index.erase(IataCode("LHR"));
+    CHECK(index.size() == 0);
+
+    // airports.dat, staged and merged as Database loads it
+    Baseline baseline;
+    for (const std::string& line : readLines(dataFile(argc, argv, "airports.dat"))) {
+        Airport airport = CSVParser::parseAirport(line);
+        IataCode code;
+        if (!airport.iata.empty() && airport.iata != "\\N" && IataCode::parse(airport.iata, code)) {
+            baseline[code.raw()] = airport.name;
+        }
+    }
+    CHECK(baseline.size() > 5000);
+    for (const auto& entry : baseline) {
+        index.stage(IataCode::fromRaw(entry.first), entry.second);
+    }
+    index.merge();
+
+    // One, two and three characters, mixed case, whole codes, name
+    // fragments, punctuation, repeated trigrams and queries with no match
+    std::vector<std::string> queries = {
+        "a", "Z", "x", "1", " ", "-", "'",
+        "la", "LA", "nY", "ew", "zz", "a ",
+        "lhr", "LHR", "jfk", "Jfk", "int", "INT", "ort", "lon",
+        "heathrow", "International", "intl airport", "san ", "saint-", "aaaa", "ooo",
+        "qqqzzz", "zzzz", "no such airport", "ab\xc3", std::string(1, '\0') + "ab"};
+    std::mt19937 rng(25);
+    std::vector<uint32_t> codes;
+    for (const auto& entry : baseline) {
+        codes.push_back(entry.first);
+    }
+    for (int i = 0; i < 60; ++i) {
+        const std::string& name = baseline[codes[rng() % codes.size()]];
+        if (name.size() < 2) {
+            continue;
+        }
+        size_t length = 1 + rng() % std::min<size_t>(name.size(), 8);
+        queries.push_back(name.substr(rng() % (name.size() - length + 1), length));
+    }
+    checkQueries(index, baseline, queries);
+    CHECK(index.search("lhr", 0).empty());
+    CHECK(index.search("", 15).empty());
+    CHECK(!index.search("LHR", 15).empty() && index.search("LHR", 15)[0] == IataCode("LHR"));
+
+    // Renames, erases and new airports, one at a time
+    for (int i = 0; i < 300; ++i) {
+        uint32_t raw = codes[rng() % codes.size()];
+        switch (rng() % 3) {
+        case 0:
+            index.erase(IataCode::fromRaw(raw));
+            baseline.erase(raw);
+            break;
+        case 1: {
+            std::string name = baseline.count(raw) ? "Renamed Field " : "New Field ";
+            name += std::to_string(i);
+            index.set(IataCode::fromRaw(raw), name);
+            baseline[raw] = name;
+            break;
+        }
+        default: {
+            std::string code = {static_cast<char>('0' + rng() % 10), static_cast<char>('A' + rng() % 26),
+                                static_cast<char>('A' + rng() % 26)};
+            index.set(IataCode(code), "Heath Field " + code);
+            baseline[IataCode(code).raw()] = "Heath Field " + code;
+            break;
+        }
+        }
+    }
+    queries.push_back("renamed");
+    queries.push_back("field 1");
+    queries.push_back("heath");
+    queries.push_back("0a");
+    checkQueries(index, baseline, queries);
+
+    // Erasing everything leaves no matches
+    for (const auto& entry : Baseline(baseline)) {
+        index.erase(IataCode::fromRaw(entry.first));
+        baseline.erase(entry.first);
+    }
+    checkQueries(index, baseline, {"a", "lon", "heath"});
+
+    return testResult();
+}